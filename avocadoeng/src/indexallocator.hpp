@@ -0,0 +1,65 @@
+#ifndef AVOCADO_CORE_INDEX_ALLOCATOR
+#define AVOCADO_CORE_INDEX_ALLOCATOR
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace avocado::core {
+
+// Hands out indices in [0, capacity). Freed indices are reused before new ones,
+// so arrays indexed by them stay dense. Not thread safe.
+class IndexAllocator {
+public:
+    static constexpr uint32_t invalidIndex = std::numeric_limits<uint32_t>::max();
+
+    explicit IndexAllocator(const uint32_t capacity) noexcept:
+        _capacity(capacity) {
+    }
+
+    // Returns invalidIndex if all indices are in use.
+    uint32_t allocate() {
+        if (!_freeIndices.empty()) {
+            const uint32_t index = _freeIndices.back();
+            _freeIndices.pop_back();
+            _isUsed[index] = true;
+            return index;
+        }
+
+        if (_nextIndex == _capacity)
+            return invalidIndex;
+
+        _isUsed.push_back(true);
+        return _nextIndex++;
+    }
+
+    // Returns false and changes nothing if the index isn't allocated, e.g. on a double free.
+    bool free(const uint32_t index) {
+        if (index >= _nextIndex || !_isUsed[index])
+            return false;
+
+        _isUsed[index] = false;
+        _freeIndices.push_back(index);
+        return true;
+    }
+
+    uint32_t getCapacity() const noexcept {
+        return _capacity;
+    }
+
+    uint32_t getUsedCount() const noexcept {
+        return _nextIndex - static_cast<uint32_t>(_freeIndices.size());
+    }
+
+private:
+    std::vector<uint32_t> _freeIndices;
+    // One bit per index below _nextIndex.
+    std::vector<bool> _isUsed;
+    // Indices from here on were never allocated.
+    uint32_t _nextIndex = 0;
+    uint32_t _capacity = 0;
+};
+
+} // namespace avocado::core.
+
+#endif
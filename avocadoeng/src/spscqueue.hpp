@@ -0,0 +1,151 @@
+#ifndef AVOCADO_CORE_SPSC_QUEUE
+#define AVOCADO_CORE_SPSC_QUEUE
+
+#include "utils.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace avocado::core {
+
+// Bounded lock-free queue for exactly one producer thread and one consumer thread.
+// push() and pop() sleep while the queue is full or empty instead of spinning, the other side
+// wakes them up. The mutex is only taken when one side sleeps. T must be default constructible and move assignable.
+template <typename T>
+class SpscQueue {
+public:
+    NON_COPYABLE(SpscQueue);
+    NON_MOVABLE(SpscQueue);
+
+    // One slot is kept empty to distinguish a full queue from an empty one.
+    explicit SpscQueue(const size_t capacity):
+        _slots(capacity + 1) {
+        assert(capacity > 0);
+    }
+
+    // Producer side. Returns false and leaves the value untouched if the queue is full.
+    bool tryPush(T &&value) {
+        const size_t tail = _tail.load(std::memory_order_relaxed);
+        const size_t nextTail = getNextIndex(tail);
+        if (nextTail == _head.load(std::memory_order_acquire))
+            return false;
+
+        _slots[tail] = std::move(value);
+        _tail.store(nextTail, std::memory_order_release);
+        notifyIfWaiting(_isConsumerWaiting, _notEmpty);
+        return true;
+    }
+
+    // Producer side. Blocks while the queue is full. Returns false and leaves the value untouched if the queue is closed.
+    bool push(T &&value) {
+        while (!tryPush(std::move(value))) {
+            std::unique_lock<std::mutex> lock(_mutex);
+            wait(lock, _isProducerWaiting, _notFull, [this]() {
+                return (_isClosed || !isFull());
+            });
+            if (_isClosed)
+                return false;
+        }
+
+        return true;
+    }
+
+    // Consumer side. Returns false if the queue is empty.
+    bool tryPop(T &value) {
+        const size_t head = _head.load(std::memory_order_relaxed);
+        if (head == _tail.load(std::memory_order_acquire))
+            return false;
+
+        value = std::move(_slots[head]);
+        _head.store(getNextIndex(head), std::memory_order_release);
+        notifyIfWaiting(_isProducerWaiting, _notFull);
+        return true;
+    }
+
+    // Consumer side. Blocks while the queue is empty. Returns false if the queue is closed and empty,
+    // values pushed before close() are still popped.
+    bool pop(T &value) {
+        while (!tryPop(value)) {
+            std::unique_lock<std::mutex> lock(_mutex);
+            wait(lock, _isConsumerWaiting, _notEmpty, [this]() {
+                return (_isClosed || !isEmpty());
+            });
+            if (_isClosed && isEmpty())
+                return false;
+        }
+
+        return true;
+    }
+
+    // Wakes up blocked push() and pop() calls, which fail from now on instead of blocking.
+    // Either side may call it, e.g. when it stops because of an error.
+    void close() {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _isClosed = true;
+        }
+        _notFull.notify_all();
+        _notEmpty.notify_all();
+    }
+
+    bool isEmpty() const noexcept {
+        return (_head.load(std::memory_order_acquire) == _tail.load(std::memory_order_acquire));
+    }
+
+    size_t getCapacity() const noexcept {
+        return _slots.size() - 1;
+    }
+
+private:
+    size_t getNextIndex(const size_t index) const noexcept {
+        return (index + 1) % _slots.size();
+    }
+
+    bool isFull() const noexcept {
+        return (getNextIndex(_tail.load(std::memory_order_acquire)) == _head.load(std::memory_order_acquire));
+    }
+
+    // The flag is set before the condition is checked and the index is stored before the flag is checked,
+    // the fences order both pairs, so either the waiting side sees the new index or the notifying side sees the flag.
+    template <typename Predicate>
+    void wait(std::unique_lock<std::mutex> &lock, std::atomic<bool> &isWaiting, std::condition_variable &condition,
+        Predicate predicate) {
+        isWaiting.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        condition.wait(lock, predicate);
+        isWaiting.store(false, std::memory_order_relaxed);
+    }
+
+    // Takes the mutex only if the other side sleeps or is about to. The waiting side checks its condition
+    // under the mutex, so locking it here makes sure the index change isn't missed before the wait.
+    void notifyIfWaiting(const std::atomic<bool> &isWaiting, std::condition_variable &condition) {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!isWaiting.load(std::memory_order_relaxed))
+            return;
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+        }
+        condition.notify_one();
+    }
+
+    std::vector<T> _slots;
+    // Separate cache lines, so producer and consumer don't invalidate each other's index.
+    alignas(64) std::atomic<size_t> _head = 0;
+    alignas(64) std::atomic<size_t> _tail = 0;
+    std::mutex _mutex;
+    std::condition_variable _notEmpty;
+    std::condition_variable _notFull;
+    std::atomic<bool> _isConsumerWaiting = false;
+    std::atomic<bool> _isProducerWaiting = false;
+    bool _isClosed = false;
+};
+
+} // namespace avocado::core.
+
+#endif
@@ -3,8 +3,10 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <fstream>
 #include <limits>
+#include <string>
 #include <type_traits>
 #include <vector>
 
@@ -51,6 +53,40 @@ void makeUniqueContainer(Container &cont) {
     cont.erase(newEnd, cont.end());
 }
 
+// FNV-1a. Unlike std::hash it is the same in every run, so it can identify data stored on disk.
+// Pass the previous result as the seed to hash several pieces of data.
+inline uint64_t hashBytes(const void *data, const size_t size, uint64_t seed = 14695981039346656037ull) noexcept {
+    const unsigned char *bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        seed ^= bytes[i];
+        seed *= 1099511628211ull;
+    }
+
+    return seed;
+}
+
+// Appends the object representation to a key, which can be compared and hashed as a whole.
+template <typename T>
+void appendKeyBytes(std::string &key, const T &value) {
+    static_assert(std::is_trivially_copyable_v<T>, "Type must be trivially copyable");
+
+    key.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+// The count is appended as well, so neighbouring arrays can't be confused.
+template <typename T>
+void appendKeyBytes(std::string &key, const T *values, const size_t count) {
+    static_assert(std::is_trivially_copyable_v<T>, "Type must be trivially copyable");
+
+    appendKeyBytes(key, count);
+    key.append(reinterpret_cast<const char*>(values), count * sizeof(T));
+}
+
+template <typename T>
+void appendKeyBytes(std::string &key, const std::vector<T> &values) {
+    appendKeyBytes(key, values.data(), values.size());
+}
+
 } // namespace avocado::utils.
 
 #endif
@@ -0,0 +1,178 @@
+#include "asynccompute.hpp"
+
+#include "buffer.hpp"
+#include "logicaldevice.hpp"
+#include "queue.hpp"
+#include "submissionbuilder.hpp"
+#include "vkutils.hpp"
+
+using namespace std::string_literals;
+
+namespace avocado::vulkan {
+
+AsyncCompute::AsyncCompute(LogicalDevice &device, const QueueFamily queueFamily, const uint32_t slotCount):
+    _device(device),
+    _queueFamily(queueFamily),
+    _commandPool(device.createObjectPointer<VkCommandPool>(VK_NULL_HANDLE)),
+    _timeline(device.createObjectPointer<VkSemaphore>(VK_NULL_HANDLE)),
+    _slotValues(slotCount, 0) {
+    assert(slotCount > 0);
+
+    _commandPool.reset(_device.createCommandPool(VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT, _queueFamily));
+    setHasError(_device.hasError());
+    if (hasError()) {
+        setErrorMessage("Can't create command pool: "s + _device.getErrorMessage());
+        return;
+    }
+
+    _commandBuffers = _device.allocateCommandBuffers(slotCount, _commandPool.get(), VK_COMMAND_BUFFER_LEVEL_PRIMARY);
+    setHasError(_device.hasError());
+    if (hasError()) {
+        setErrorMessage("Can't allocate command buffers: "s + _device.getErrorMessage());
+        return;
+    }
+
+    _timeline.reset(_device.createTimelineSemaphore(0));
+    setHasError(_device.hasError());
+    if (hasError())
+        setErrorMessage("Can't create timeline semaphore: "s + _device.getErrorMessage());
+}
+
+AsyncCompute::~AsyncCompute() {
+    // The command buffers are freed with the pool, which the GPU may still use.
+    if (_submittedValue > 0)
+        wait(_submittedValue);
+}
+
+CommandBuffer &AsyncCompute::begin(const uint32_t slot) {
+    assert(slot < _commandBuffers.size());
+    assert(!_isRecording);
+
+    _slot = slot;
+    _releaseBarriers.clear();
+    _acquireBarriers.clear();
+    CommandBuffer &commandBuffer = _commandBuffers[_slot];
+
+    wait(_slotValues[_slot]);
+    if (hasError())
+        return commandBuffer;
+
+    commandBuffer.reset(static_cast<VkCommandPoolResetFlagBits>(0));
+    setHasError(commandBuffer.hasError());
+    if (hasError()) {
+        setErrorMessage("Can't reset command buffer: "s + commandBuffer.getErrorMessage());
+        return commandBuffer;
+    }
+
+    commandBuffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+    setHasError(commandBuffer.hasError());
+    if (hasError()) {
+        setErrorMessage("Can't begin command buffer: "s + commandBuffer.getErrorMessage());
+        return commandBuffer;
+    }
+
+    _isRecording = true;
+    return commandBuffer;
+}
+
+void AsyncCompute::releaseBuffer(Buffer &buffer, const VkPipelineStageFlags2 srcStages, const VkAccessFlags2 srcAccess,
+    const VkAccessFlags2 dstAccess, const QueueFamily dstQueueFamily) {
+    assert(_isRecording);
+
+    // Within one family the semaphore signal already makes the writes available to the waiting queue.
+    if (_queueFamily == dstQueueFamily)
+        return;
+
+    // Both halves must describe the same transfer. Access masks of the other queue are ignored.
+    VkBufferMemoryBarrier2 releaseBarrier{}; FILL_S_TYPE(releaseBarrier);
+    releaseBarrier.srcStageMask = srcStages;
+    releaseBarrier.srcAccessMask = srcAccess;
+    releaseBarrier.srcQueueFamilyIndex = _queueFamily;
+    releaseBarrier.dstQueueFamilyIndex = dstQueueFamily;
+    releaseBarrier.buffer = buffer.getHandle();
+    releaseBarrier.offset = 0;
+    releaseBarrier.size = VK_WHOLE_SIZE;
+    _releaseBarriers.push_back(releaseBarrier);
+
+    VkBufferMemoryBarrier2 acquireBarrier = releaseBarrier;
+    acquireBarrier.srcStageMask = VK_PIPELINE_STAGE_2_NONE;
+    acquireBarrier.srcAccessMask = VK_ACCESS_2_NONE;
+    acquireBarrier.dstAccessMask = dstAccess;
+    _acquireBarriers.push_back(acquireBarrier);
+}
+
+void AsyncCompute::recordAcquireBarriers(CommandBuffer &commandBuffer, const VkPipelineStageFlags2 dstStages) const noexcept {
+    if (_acquireBarriers.empty())
+        return;
+
+    std::vector<VkBufferMemoryBarrier2> barriers = _acquireBarriers;
+    for (VkBufferMemoryBarrier2 &barrier : barriers) {
+        barrier.srcStageMask = dstStages;
+        barrier.dstStageMask = dstStages;
+    }
+
+    commandBuffer.pipelineBarrier2(barriers, {});
+}
+
+uint64_t AsyncCompute::submit(Queue &queue) {
+    assert(_isRecording);
+
+    CommandBuffer &commandBuffer = _commandBuffers[_slot];
+    if (!_releaseBarriers.empty())
+        commandBuffer.pipelineBarrier2(_releaseBarriers, {});
+
+    commandBuffer.end();
+    _isRecording = false;
+    setHasError(commandBuffer.hasError());
+    if (hasError()) {
+        setErrorMessage("Can't end command buffer: "s + commandBuffer.getErrorMessage());
+        return 0;
+    }
+
+    const uint64_t value = _submittedValue + 1;
+    SubmissionBuilder submission;
+    submission.nextBatch();
+    submission.addCommandBuffer(commandBuffer.getHandle());
+    submission.addSignalSemaphore(_timeline.get(), VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, value);
+    queue.submit(submission);
+    setHasError(queue.hasError());
+    if (hasError()) {
+        setErrorMessage("Can't submit compute work: "s + queue.getErrorMessage());
+        return 0;
+    }
+
+    _submittedValue = value;
+    _slotValues[_slot] = value;
+    return value;
+}
+
+QueueFamily AsyncCompute::getQueueFamily() const noexcept {
+    return _queueFamily;
+}
+
+VkSemaphore AsyncCompute::getTimeline() noexcept {
+    return _timeline.get();
+}
+
+bool AsyncCompute::isComplete(const uint64_t value) noexcept {
+    const uint64_t completedValue = _device.getSemaphoreCounterValue(_timeline.get());
+    setHasError(_device.hasError());
+    if (hasError())
+        setErrorMessage("Can't get timeline value: "s + _device.getErrorMessage());
+
+    return (completedValue >= value);
+}
+
+void AsyncCompute::wait(const uint64_t value, const uint64_t timeout) noexcept {
+    // Value 0 is never signaled, nothing was submitted.
+    setHasError(false);
+    if (value == 0)
+        return;
+
+    _device.waitForSemaphore(_timeline.get(), value, timeout);
+    setHasError(_device.hasError());
+    if (hasError())
+        setErrorMessage("Can't wait for compute work: "s + _device.getErrorMessage());
+}
+
+} // namespace avocado::vulkan.
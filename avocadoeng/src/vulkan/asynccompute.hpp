@@ -0,0 +1,68 @@
+#ifndef AVOCADO_VULKAN_ASYNC_COMPUTE
+#define AVOCADO_VULKAN_ASYNC_COMPUTE
+
+#include "commandbuffer.hpp"
+#include "pointertypes.hpp"
+#include "types.hpp"
+
+#include "../errorstorage.hpp"
+#include "../utils.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <limits>
+#include <vector>
+
+namespace avocado::vulkan {
+
+class Buffer;
+class LogicalDevice;
+class Queue;
+
+// Per-frame compute work on the compute queue family, overlapping with graphics work of other frames.
+// Submission N signals value N of a timeline semaphore, the graphics submission which consumes the
+// results waits for it (FrameScheduler::addWaitSemaphore()). Each slot has its own command buffer,
+// begin() waits until the previous submission of the slot is done. Not thread safe.
+class AsyncCompute: public core::ErrorStorage {
+public:
+    NON_COPYABLE(AsyncCompute);
+    NON_MOVABLE(AsyncCompute);
+
+    explicit AsyncCompute(LogicalDevice &device, const QueueFamily queueFamily, const uint32_t slotCount);
+    ~AsyncCompute();
+
+    // Returns the command buffer of the slot ready for recording.
+    CommandBuffer &begin(const uint32_t slot);
+    // Queue family ownership transfer of a buffer the recorded commands wrote. The release half is recorded now,
+    // the acquire half is recorded on the destination queue with recordAcquireBarriers() after it waits for the
+    // value returned by submit(). With equal families the semaphore is enough and nothing is recorded.
+    void releaseBuffer(Buffer &buffer, const VkPipelineStageFlags2 srcStages, const VkAccessFlags2 srcAccess,
+        const VkAccessFlags2 dstAccess, const QueueFamily dstQueueFamily);
+    // Source stages are the same as the destination ones, they have to match the semaphore wait stages.
+    void recordAcquireBarriers(CommandBuffer &commandBuffer, const VkPipelineStageFlags2 dstStages) const noexcept;
+    // Returns the timeline value which is signaled when the commands are done.
+    uint64_t submit(Queue &queue);
+
+    QueueFamily getQueueFamily() const noexcept;
+    VkSemaphore getTimeline() noexcept;
+    bool isComplete(const uint64_t value) noexcept;
+    void wait(const uint64_t value, const uint64_t timeout = std::numeric_limits<uint64_t>::max()) noexcept;
+
+private:
+    LogicalDevice &_device;
+    QueueFamily _queueFamily = 0;
+    CommandPoolPtr _commandPool;
+    SemaphorePtr _timeline;
+    std::vector<CommandBuffer> _commandBuffers;
+    // Timeline value of the last submission of each slot.
+    std::vector<uint64_t> _slotValues;
+    std::vector<VkBufferMemoryBarrier2> _releaseBarriers;
+    std::vector<VkBufferMemoryBarrier2> _acquireBarriers;
+    uint64_t _submittedValue = 0;
+    uint32_t _slot = 0;
+    bool _isRecording = false;
+};
+
+} // namespace avocado::vulkan.
+
+#endif
@@ -0,0 +1,158 @@
+#include "bindlesstable.hpp"
+
+#include "vkutils.hpp"
+
+#include <array>
+#include <cassert>
+
+using namespace std::string_literals;
+
+namespace avocado::vulkan {
+
+BindlessTable::BindlessTable(VkDevice device, const uint32_t textureCapacity, const uint32_t bufferCapacity):
+    _device(device),
+    _textureIndices(textureCapacity),
+    _bufferIndices(bufferCapacity) {
+    std::array<VkDescriptorSetLayoutBinding, 2> bindings{};
+    bindings[0].binding = textureBinding;
+    bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    bindings[0].descriptorCount = textureCapacity;
+    bindings[0].stageFlags = VK_SHADER_STAGE_ALL;
+    bindings[1].binding = bufferBinding;
+    bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    bindings[1].descriptorCount = bufferCapacity;
+    bindings[1].stageFlags = VK_SHADER_STAGE_ALL;
+
+    const VkDescriptorBindingFlags bindingFlags = VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT |
+        VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT | VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT;
+    const std::array<VkDescriptorBindingFlags, 2> bindingFlagArray {bindingFlags, bindingFlags};
+    VkDescriptorSetLayoutBindingFlagsCreateInfo bindingFlagsCI{}; FILL_S_TYPE(bindingFlagsCI);
+    bindingFlagsCI.bindingCount = static_cast<uint32_t>(bindingFlagArray.size());
+    bindingFlagsCI.pBindingFlags = bindingFlagArray.data();
+
+    VkDescriptorSetLayoutCreateInfo layoutCI{}; FILL_S_TYPE(layoutCI);
+    layoutCI.pNext = &bindingFlagsCI;
+    layoutCI.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT;
+    layoutCI.bindingCount = static_cast<uint32_t>(bindings.size());
+    layoutCI.pBindings = bindings.data();
+
+    VkResult result = vkCreateDescriptorSetLayout(_device, &layoutCI, nullptr, &_layout);
+    setHasError(result != VK_SUCCESS);
+    if (hasError()) {
+        setErrorMessage("vkCreateDescriptorSetLayout returned "s + getVkResultString(result));
+        return;
+    }
+
+    const std::array<VkDescriptorPoolSize, 2> poolSizes {
+        VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, textureCapacity},
+        VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, bufferCapacity}
+    };
+    VkDescriptorPoolCreateInfo poolCI{}; FILL_S_TYPE(poolCI);
+    poolCI.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT;
+    poolCI.maxSets = 1;
+    poolCI.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+    poolCI.pPoolSizes = poolSizes.data();
+
+    result = vkCreateDescriptorPool(_device, &poolCI, nullptr, &_pool);
+    setHasError(result != VK_SUCCESS);
+    if (hasError()) {
+        setErrorMessage("vkCreateDescriptorPool returned "s + getVkResultString(result));
+        return;
+    }
+
+    VkDescriptorSetAllocateInfo allocInfo{}; FILL_S_TYPE(allocInfo);
+    allocInfo.descriptorPool = _pool;
+    allocInfo.descriptorSetCount = 1;
+    allocInfo.pSetLayouts = &_layout;
+
+    result = vkAllocateDescriptorSets(_device, &allocInfo, &_descriptorSet);
+    setHasError(result != VK_SUCCESS);
+    if (hasError())
+        setErrorMessage("vkAllocateDescriptorSets returned "s + getVkResultString(result));
+}
+
+BindlessTable::~BindlessTable() {
+    // The set is freed with the pool.
+    if (_pool != VK_NULL_HANDLE)
+        vkDestroyDescriptorPool(_device, _pool, nullptr);
+
+    if (_layout != VK_NULL_HANDLE)
+        vkDestroyDescriptorSetLayout(_device, _layout, nullptr);
+}
+
+VkDescriptorSetLayout BindlessTable::getLayout() noexcept {
+    return _layout;
+}
+
+VkDescriptorSet BindlessTable::getDescriptorSet() noexcept {
+    return _descriptorSet;
+}
+
+uint32_t BindlessTable::addTexture(VkImageView imageView, VkSampler sampler, const VkImageLayout imageLayout) {
+    const uint32_t index = _textureIndices.allocate();
+    setHasError(index == invalidIndex);
+    if (hasError()) {
+        setErrorMessage("Bindless texture table is full");
+        return invalidIndex;
+    }
+
+    VkDescriptorImageInfo imageInfo{};
+    imageInfo.sampler = sampler;
+    imageInfo.imageView = imageView;
+    imageInfo.imageLayout = imageLayout;
+
+    VkWriteDescriptorSet descriptorWrite{}; FILL_S_TYPE(descriptorWrite);
+    descriptorWrite.dstSet = _descriptorSet;
+    descriptorWrite.dstBinding = textureBinding;
+    descriptorWrite.dstArrayElement = index;
+    descriptorWrite.descriptorCount = 1;
+    descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    descriptorWrite.pImageInfo = &imageInfo;
+    vkUpdateDescriptorSets(_device, 1, &descriptorWrite, 0, nullptr);
+    return index;
+}
+
+uint32_t BindlessTable::addBuffer(VkBuffer buffer, const VkDeviceSize offset, const VkDeviceSize range) {
+    const uint32_t index = _bufferIndices.allocate();
+    setHasError(index == invalidIndex);
+    if (hasError()) {
+        setErrorMessage("Bindless buffer table is full");
+        return invalidIndex;
+    }
+
+    VkDescriptorBufferInfo bufferInfo{};
+    bufferInfo.buffer = buffer;
+    bufferInfo.offset = offset;
+    bufferInfo.range = range;
+
+    VkWriteDescriptorSet descriptorWrite{}; FILL_S_TYPE(descriptorWrite);
+    descriptorWrite.dstSet = _descriptorSet;
+    descriptorWrite.dstBinding = bufferBinding;
+    descriptorWrite.dstArrayElement = index;
+    descriptorWrite.descriptorCount = 1;
+    descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    descriptorWrite.pBufferInfo = &bufferInfo;
+    vkUpdateDescriptorSets(_device, 1, &descriptorWrite, 0, nullptr);
+    return index;
+}
+
+void BindlessTable::removeTexture(const uint32_t index) {
+    // The element keeps its descriptor, partially bound arrays allow it as long as shaders don't use it.
+    [[maybe_unused]] const bool isFreed = _textureIndices.free(index);
+    assert(isFreed);
+}
+
+void BindlessTable::removeBuffer(const uint32_t index) {
+    [[maybe_unused]] const bool isFreed = _bufferIndices.free(index);
+    assert(isFreed);
+}
+
+uint32_t BindlessTable::getTextureCount() const noexcept {
+    return _textureIndices.getUsedCount();
+}
+
+uint32_t BindlessTable::getBufferCount() const noexcept {
+    return _bufferIndices.getUsedCount();
+}
+
+} // namespace avocado::vulkan.
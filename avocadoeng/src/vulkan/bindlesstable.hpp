@@ -0,0 +1,59 @@
+#ifndef AVOCADO_VULKAN_BINDLESS_TABLE
+#define AVOCADO_VULKAN_BINDLESS_TABLE
+
+#include "../errorstorage.hpp"
+#include "../indexallocator.hpp"
+#include "../utils.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+namespace avocado::vulkan {
+
+// One descriptor set with large arrays of textures and storage buffers, bound once for all draws.
+// Shaders pick resources by index, e.g. from push constants or instance data, so draws with different
+// textures don't switch descriptor sets and can be batched. Elements can be written while the set is
+// bound in recorded command buffers, unused elements don't have to be valid.
+// Requires descriptor indexing, see LogicalDevice::isDescriptorIndexingEnabled(). Not thread safe.
+class BindlessTable: public core::ErrorStorage {
+public:
+    NON_COPYABLE(BindlessTable);
+    NON_MOVABLE(BindlessTable);
+
+    // Declared in shaders as
+    //     layout(set = N, binding = 0) uniform sampler2D textures[];
+    //     layout(set = N, binding = 1) buffer Buffers { ... } buffers[];
+    static constexpr uint32_t textureBinding = 0;
+    static constexpr uint32_t bufferBinding = 1;
+    static constexpr uint32_t invalidIndex = core::IndexAllocator::invalidIndex;
+
+    // Capacities must not exceed the update after bind limits of the device.
+    BindlessTable(VkDevice device, const uint32_t textureCapacity, const uint32_t bufferCapacity);
+    ~BindlessTable();
+
+    VkDescriptorSetLayout getLayout() noexcept;
+    VkDescriptorSet getDescriptorSet() noexcept;
+
+    // Returns the array index, or invalidIndex if the table is full.
+    uint32_t addTexture(VkImageView imageView, VkSampler sampler,
+        const VkImageLayout imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    uint32_t addBuffer(VkBuffer buffer, const VkDeviceSize offset = 0, const VkDeviceSize range = VK_WHOLE_SIZE);
+    // The index is reused by the next add, so remove only once the GPU is done with it,
+    // e.g. from FrameScheduler::retire().
+    void removeTexture(const uint32_t index);
+    void removeBuffer(const uint32_t index);
+
+    uint32_t getTextureCount() const noexcept;
+    uint32_t getBufferCount() const noexcept;
+
+private:
+    VkDevice _device = VK_NULL_HANDLE;
+    VkDescriptorSetLayout _layout = VK_NULL_HANDLE;
+    VkDescriptorPool _pool = VK_NULL_HANDLE;
+    VkDescriptorSet _descriptorSet = VK_NULL_HANDLE;
+    core::IndexAllocator _textureIndices;
+    core::IndexAllocator _bufferIndices;
+};
+
+} // namespace avocado::vulkan.
+
+#endif
@@ -16,6 +16,7 @@ namespace avocado::vulkan {
 Buffer::Buffer(const VkDeviceSize size, const VkBufferUsageFlagBits usage, const VkSharingMode sharingMode, LogicalDevice &logicalDevice,
     const std::vector<QueueFamily> &queueFamilies):
     _dev(logicalDevice.getHandle()),
+    _descriptorSetCache(&logicalDevice.getDescriptorSetCache()),
     _bufSize(size) {
     VkBufferCreateInfo bufferCI{}; FILL_S_TYPE(bufferCI);
     bufferCI.size = _bufSize;
@@ -35,10 +36,12 @@ Buffer::Buffer(const VkDeviceSize size, const VkBufferUsageFlagBits usage, const
 
 Buffer::Buffer(Buffer &&other):
     _dev(std::move(other._dev))
+    , _descriptorSetCache(other._descriptorSetCache)
     , _buf(std::move(other._buf))
     , _devMem(std::move(other._devMem))
     , _bufSize(std::move(other._bufSize)) {
     other._dev = VK_NULL_HANDLE;
+    other._descriptorSetCache = nullptr;
     other._buf = VK_NULL_HANDLE;
     other._devMem = VK_NULL_HANDLE;
     other._bufSize = 0;
@@ -48,11 +51,13 @@ Buffer& Buffer::operator=(Buffer &&other) {
     core::ErrorStorage::operator=(other);
 
     _dev = std::move(other._dev);
+    _descriptorSetCache = other._descriptorSetCache;
     _buf = std::move(other._buf);
     _devMem = std::move(other._devMem);
     _bufSize = std::move(other._bufSize);
 
     other._dev = VK_NULL_HANDLE;
+    other._descriptorSetCache = nullptr;
     other._buf = VK_NULL_HANDLE;
     other._devMem = VK_NULL_HANDLE;
     other._bufSize = 0;
@@ -61,6 +66,8 @@ Buffer& Buffer::operator=(Buffer &&other) {
 }
 
 Buffer::~Buffer() {
+    if (_buf != VK_NULL_HANDLE && _descriptorSetCache != nullptr)
+        _descriptorSetCache->invalidateBuffer(_buf);
     if (_devMem != VK_NULL_HANDLE)
         vkFreeMemory(_dev, _devMem, nullptr);
     if (_buf != VK_NULL_HANDLE)
@@ -71,26 +78,19 @@ VkBuffer Buffer::getHandle() noexcept {
     return _buf;
 }
 
-void Buffer::allocateMemory(PhysicalDevice &physDevice, const VkMemoryPropertyFlags memoryFlags) {
+void Buffer::allocateMemory(PhysicalDevice &physDevice, const MemoryUsage usage) {
     assert(_buf != VK_NULL_HANDLE && _dev != VK_NULL_HANDLE);
     assert(_devMem == VK_NULL_HANDLE);
 
-    // Memory requirements.
     VkMemoryRequirements memReq{};
     vkGetBufferMemoryRequirements(_dev, _buf, &memReq);
 
-    const uint32_t foundType = physDevice.findMemoryTypeIndex(memoryFlags, memReq.memoryTypeBits);
-
-    // Allocate memory.
-    VkMemoryAllocateInfo memAllocInfo{}; FILL_S_TYPE(memAllocInfo);
-    memAllocInfo.allocationSize = memReq.size;
-    memAllocInfo.memoryTypeIndex = foundType;
-
-    const VkResult allocRes = vkAllocateMemory(_dev, &memAllocInfo, nullptr, &_devMem);
+    const VkResult allocRes = physDevice.allocateMemory(_dev, memReq, usage, _devMem);
     setHasError(allocRes != VK_SUCCESS);
-    if (hasError()) {
+    if (allocRes == VK_ERROR_FEATURE_NOT_PRESENT)
+        setErrorMessage("No memory type qualifies for the buffer");
+    else if (hasError())
         setErrorMessage("vkAllocateMemory returned "s + getVkResultString(allocRes));
-    }
 }
 
 void Buffer::bindMemory(const VkDeviceSize offset) noexcept {
@@ -11,6 +11,7 @@
 namespace avocado::vulkan {
 
 class CommandBuffer;
+class DescriptorSetCache;
 class Image;
 class LogicalDevice;
 class PhysicalDevice;
@@ -25,7 +26,7 @@ public:
     ~Buffer();
 
     VkBuffer getHandle() noexcept;
-    void allocateMemory(PhysicalDevice &physDevice, const VkMemoryPropertyFlags memoryFlags);
+    void allocateMemory(PhysicalDevice &physDevice, const MemoryUsage usage);
     void bindMemory(const VkDeviceSize offset = 0) noexcept;
     void copyToImage(Image &image, const uint32_t width, const uint32_t height, CommandBuffer &commandBuffer);
     void fill(const void * const dataToCopy, const VkDeviceSize dataSize, const size_t offset = 0);
@@ -36,6 +37,8 @@ public:
 
 private:
     VkDevice _dev = VK_NULL_HANDLE;
+    // Invalidated when the buffer is destroyed.
+    DescriptorSetCache *_descriptorSetCache = nullptr;
     VkBuffer _buf = VK_NULL_HANDLE;
     VkDeviceMemory _devMem = VK_NULL_HANDLE;
     VkDeviceSize _bufSize = 0;
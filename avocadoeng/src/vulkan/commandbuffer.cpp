@@ -35,6 +35,25 @@ void CommandBuffer::begin(const VkCommandBufferUsageFlags flags) noexcept {
     }
 }
 
+void CommandBuffer::beginSecondary(VkRenderPass renderPass, const uint32_t subpass, const VkCommandBufferUsageFlags flags) noexcept {
+    assert(_buf != VK_NULL_HANDLE);
+
+    VkCommandBufferInheritanceInfo inheritanceInfo{}; FILL_S_TYPE(inheritanceInfo);
+    inheritanceInfo.renderPass = renderPass;
+    inheritanceInfo.subpass = subpass;
+    // Framebuffer is left unknown, so the same commands work for every swapchain image.
+    inheritanceInfo.framebuffer = VK_NULL_HANDLE;
+
+    VkCommandBufferBeginInfo beginInfo{}; FILL_S_TYPE(beginInfo);
+    beginInfo.flags = flags | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+    beginInfo.pInheritanceInfo = &inheritanceInfo;
+    const VkResult result = vkBeginCommandBuffer(_buf, &beginInfo);
+    setHasError(result != VK_SUCCESS);
+    if (hasError()) {
+        setErrorMessage("vkBeginCommandBuffer returned "s + getVkResultString(result));
+    }
+}
+
 void CommandBuffer::end() noexcept {
     assert(_buf != VK_NULL_HANDLE);
 
@@ -45,7 +64,8 @@ void CommandBuffer::end() noexcept {
     }
 }
 
-void CommandBuffer::beginRenderPass(Swapchain &swapchain, VkRenderPass renderPass, const VkExtent2D extent, const VkOffset2D offset, const uint32_t imageIndex) noexcept {
+void CommandBuffer::beginRenderPass(Swapchain &swapchain, VkRenderPass renderPass, const VkExtent2D extent, const VkOffset2D offset, const uint32_t imageIndex,
+    const VkSubpassContents contents) noexcept {
     assert(_buf != VK_NULL_HANDLE);
 
     VkRenderPassBeginInfo renderPassInfo{}; FILL_S_TYPE(renderPassInfo);
@@ -58,7 +78,7 @@ void CommandBuffer::beginRenderPass(Swapchain &swapchain, VkRenderPass renderPas
 
     renderPassInfo.clearValueCount = 1;
     renderPassInfo.pClearValues = &clearColor;
-    vkCmdBeginRenderPass(_buf, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+    vkCmdBeginRenderPass(_buf, &renderPassInfo, contents);
 }
 
 void CommandBuffer::endRenderPass() noexcept {
@@ -74,6 +94,35 @@ void CommandBuffer::copyBuffer(Buffer &srcBuf, Buffer &dstBuf, const std::vector
         static_cast<uint32_t>(regions.size()), regions.data());
 }
 
+void CommandBuffer::pipelineBarrier(const VkPipelineStageFlags srcStages, const VkPipelineStageFlags dstStages,
+    const std::vector<VkImageMemoryBarrier> &imageBarriers) noexcept {
+    assert(_buf != VK_NULL_HANDLE);
+
+    vkCmdPipelineBarrier(_buf, srcStages, dstStages, 0, 0, nullptr, 0, nullptr,
+        static_cast<uint32_t>(imageBarriers.size()), imageBarriers.data());
+}
+
+void CommandBuffer::pipelineBarrier(const VkPipelineStageFlags srcStages, const VkPipelineStageFlags dstStages,
+    const std::vector<VkBufferMemoryBarrier> &bufferBarriers, const std::vector<VkImageMemoryBarrier> &imageBarriers) noexcept {
+    assert(_buf != VK_NULL_HANDLE);
+
+    vkCmdPipelineBarrier(_buf, srcStages, dstStages, 0, 0, nullptr,
+        static_cast<uint32_t>(bufferBarriers.size()), bufferBarriers.data(),
+        static_cast<uint32_t>(imageBarriers.size()), imageBarriers.data());
+}
+
+void CommandBuffer::pipelineBarrier2(const std::vector<VkBufferMemoryBarrier2> &bufferBarriers,
+    const std::vector<VkImageMemoryBarrier2> &imageBarriers) noexcept {
+    assert(_buf != VK_NULL_HANDLE);
+
+    VkDependencyInfo dependencyInfo{}; FILL_S_TYPE(dependencyInfo);
+    dependencyInfo.bufferMemoryBarrierCount = static_cast<uint32_t>(bufferBarriers.size());
+    dependencyInfo.pBufferMemoryBarriers = bufferBarriers.data();
+    dependencyInfo.imageMemoryBarrierCount = static_cast<uint32_t>(imageBarriers.size());
+    dependencyInfo.pImageMemoryBarriers = imageBarriers.data();
+    vkCmdPipelineBarrier2(_buf, &dependencyInfo);
+}
+
 void CommandBuffer::bindVertexBuffers(const uint32_t firstBinding, const uint32_t bindingCount,
     VkBuffer *buffers, VkDeviceSize *offsets) noexcept {
     assert(_buf != VK_NULL_HANDLE);
@@ -94,6 +143,29 @@ void CommandBuffer::bindDescriptorSets(const VkPipelineBindPoint bindPoint, VkPi
     vkCmdBindDescriptorSets(_buf, bindPoint, pipelineLayout, firstSet, setCount, sets, dynamicOffsetCount, dynamicOffsets);
 }
 
+void CommandBuffer::pushDescriptorSet(const PushDescriptorCommands &commands, const VkPipelineBindPoint bindPoint,
+    VkPipelineLayout pipelineLayout, const uint32_t set, const std::vector<VkWriteDescriptorSet> &descriptorWrites) noexcept {
+    assert(_buf != VK_NULL_HANDLE);
+    assert(commands.pushDescriptorSet != nullptr);
+
+    commands.pushDescriptorSet(_buf, bindPoint, pipelineLayout, set, static_cast<uint32_t>(descriptorWrites.size()), descriptorWrites.data());
+}
+
+void CommandBuffer::pushDescriptorSetWithTemplate(const PushDescriptorCommands &commands, VkDescriptorUpdateTemplate updateTemplate,
+    VkPipelineLayout pipelineLayout, const uint32_t set, const void *data) noexcept {
+    assert(_buf != VK_NULL_HANDLE);
+    assert(commands.pushDescriptorSetWithTemplate != nullptr);
+
+    commands.pushDescriptorSetWithTemplate(_buf, updateTemplate, pipelineLayout, set, data);
+}
+
+void CommandBuffer::pushConstants(VkPipelineLayout pipelineLayout, const VkShaderStageFlags stageFlags, const uint32_t offset,
+    const uint32_t size, const void *values) noexcept {
+    assert(_buf != VK_NULL_HANDLE);
+
+    vkCmdPushConstants(_buf, pipelineLayout, stageFlags, offset, size, values);
+}
+
 void CommandBuffer::draw(const uint32_t vertexCount, const uint32_t instanceCount,
         const uint32_t firstVertex, const uint32_t firstInstance) noexcept {
     assert(_buf != VK_NULL_HANDLE);
@@ -108,6 +180,18 @@ void CommandBuffer::drawIndexed(const uint32_t indexCount, const uint32_t instan
     vkCmdDrawIndexed(_buf, indexCount, instanceCount, firstIndex, vertexOffset, firstInstance);
 }
 
+void CommandBuffer::dispatch(const uint32_t groupCountX, const uint32_t groupCountY, const uint32_t groupCountZ) noexcept {
+    assert(_buf != VK_NULL_HANDLE);
+
+    vkCmdDispatch(_buf, groupCountX, groupCountY, groupCountZ);
+}
+
+void CommandBuffer::dispatchIndirect(Buffer &buffer, const VkDeviceSize offset) noexcept {
+    assert(_buf != VK_NULL_HANDLE);
+
+    vkCmdDispatchIndirect(_buf, buffer.getHandle(), offset);
+}
+
 void CommandBuffer::reset(const VkCommandPoolResetFlagBits flags) {
     assert(_buf != VK_NULL_HANDLE);
 
@@ -129,11 +213,86 @@ void CommandBuffer::setScissors(const std::vector<VkRect2D> &scissors, const uin
     vkCmdSetScissor(_buf, firstIndex, count, scissors.data());
 }
 
+void CommandBuffer::setCullMode(const VkCullModeFlags cullMode) noexcept {
+    assert(_buf != VK_NULL_HANDLE);
+
+    vkCmdSetCullMode(_buf, cullMode);
+}
+
+void CommandBuffer::setFrontFace(const VkFrontFace frontFace) noexcept {
+    assert(_buf != VK_NULL_HANDLE);
+
+    vkCmdSetFrontFace(_buf, frontFace);
+}
+
+void CommandBuffer::setPrimitiveTopology(const VkPrimitiveTopology topology) noexcept {
+    assert(_buf != VK_NULL_HANDLE);
+
+    vkCmdSetPrimitiveTopology(_buf, topology);
+}
+
+void CommandBuffer::setDepthTestEnable(const bool enable) noexcept {
+    assert(_buf != VK_NULL_HANDLE);
+
+    vkCmdSetDepthTestEnable(_buf, enable ? VK_TRUE : VK_FALSE);
+}
+
+void CommandBuffer::setDepthWriteEnable(const bool enable) noexcept {
+    assert(_buf != VK_NULL_HANDLE);
+
+    vkCmdSetDepthWriteEnable(_buf, enable ? VK_TRUE : VK_FALSE);
+}
+
+void CommandBuffer::setDepthCompareOp(const VkCompareOp compareOp) noexcept {
+    assert(_buf != VK_NULL_HANDLE);
+
+    vkCmdSetDepthCompareOp(_buf, compareOp);
+}
+
+void CommandBuffer::setDepthBiasEnable(const bool enable) noexcept {
+    assert(_buf != VK_NULL_HANDLE);
+
+    vkCmdSetDepthBiasEnable(_buf, enable ? VK_TRUE : VK_FALSE);
+}
+
+void CommandBuffer::setRasterizerDiscardEnable(const bool enable) noexcept {
+    assert(_buf != VK_NULL_HANDLE);
+
+    vkCmdSetRasterizerDiscardEnable(_buf, enable ? VK_TRUE : VK_FALSE);
+}
+
+void CommandBuffer::setPrimitiveRestartEnable(const bool enable) noexcept {
+    assert(_buf != VK_NULL_HANDLE);
+
+    vkCmdSetPrimitiveRestartEnable(_buf, enable ? VK_TRUE : VK_FALSE);
+}
+
+void CommandBuffer::setColorBlendEnable(const ExtendedDynamicState3Commands &commands, const uint32_t firstAttachment,
+    const std::vector<VkBool32> &enables) noexcept {
+    assert(_buf != VK_NULL_HANDLE);
+    assert(commands.setColorBlendEnable != nullptr);
+
+    commands.setColorBlendEnable(_buf, firstAttachment, static_cast<uint32_t>(enables.size()), enables.data());
+}
+
+void CommandBuffer::setPolygonMode(const ExtendedDynamicState3Commands &commands, const VkPolygonMode polygonMode) noexcept {
+    assert(_buf != VK_NULL_HANDLE);
+    assert(commands.setPolygonMode != nullptr);
+
+    commands.setPolygonMode(_buf, polygonMode);
+}
+
 void CommandBuffer::bindPipeline(VkPipeline pipeline, const VkPipelineBindPoint bindPoint) noexcept {
     assert(_buf != VK_NULL_HANDLE);
 
     vkCmdBindPipeline(_buf, bindPoint, pipeline);
 }
 
+void CommandBuffer::executeCommands(const std::vector<VkCommandBuffer> &commandBuffers) noexcept {
+    assert(_buf != VK_NULL_HANDLE);
+
+    vkCmdExecuteCommands(_buf, static_cast<uint32_t>(commandBuffers.size()), commandBuffers.data());
+}
+
 }
 
@@ -5,6 +5,7 @@
 
 #include <vulkan/vulkan_core.h>
 
+#include <type_traits>
 #include <vector>
 
 namespace avocado::vulkan {
@@ -12,6 +13,18 @@ namespace avocado::vulkan {
 class Buffer;
 class Swapchain;
 
+// VK_EXT_extended_dynamic_state3 commands, the logical device loads them if the extension is enabled.
+struct ExtendedDynamicState3Commands {
+    PFN_vkCmdSetColorBlendEnableEXT setColorBlendEnable = nullptr;
+    PFN_vkCmdSetPolygonModeEXT setPolygonMode = nullptr;
+};
+
+// VK_KHR_push_descriptor commands, the logical device loads them if the extension is enabled.
+struct PushDescriptorCommands {
+    PFN_vkCmdPushDescriptorSetKHR pushDescriptorSet = nullptr;
+    PFN_vkCmdPushDescriptorSetWithTemplateKHR pushDescriptorSetWithTemplate = nullptr;
+};
+
 class CommandBuffer: public core::ErrorStorage {
 public:
     CommandBuffer() = default;
@@ -21,19 +34,56 @@ public:
     bool isValid() const noexcept;
 
     void begin(const VkCommandBufferUsageFlags flags = 0) noexcept;
+    // Begins a secondary command buffer which continues the subpass of the render pass.
+    void beginSecondary(VkRenderPass renderPass, const uint32_t subpass, const VkCommandBufferUsageFlags flags = 0) noexcept;
     void end() noexcept;
-    void beginRenderPass(Swapchain &swapchain, VkRenderPass renderPass, const VkExtent2D extent, const VkOffset2D offset, const uint32_t imageIndex) noexcept;
+    void beginRenderPass(Swapchain &swapchain, VkRenderPass renderPass, const VkExtent2D extent, const VkOffset2D offset, const uint32_t imageIndex,
+        const VkSubpassContents contents = VK_SUBPASS_CONTENTS_INLINE) noexcept;
     void endRenderPass() noexcept;
 
     void copyBuffer(Buffer &srcBuf, Buffer &dstBuf, const std::vector<VkBufferCopy> &regions) noexcept;
+    void pipelineBarrier(const VkPipelineStageFlags srcStages, const VkPipelineStageFlags dstStages,
+        const std::vector<VkImageMemoryBarrier> &imageBarriers) noexcept;
+    void pipelineBarrier(const VkPipelineStageFlags srcStages, const VkPipelineStageFlags dstStages,
+        const std::vector<VkBufferMemoryBarrier> &bufferBarriers, const std::vector<VkImageMemoryBarrier> &imageBarriers) noexcept;
+    // Synchronization2 barriers carry their own stage masks, all of them are recorded with one call.
+    void pipelineBarrier2(const std::vector<VkBufferMemoryBarrier2> &bufferBarriers, const std::vector<VkImageMemoryBarrier2> &imageBarriers) noexcept;
     void bindVertexBuffers(const uint32_t firstBinding, const uint32_t bindingCount, VkBuffer *buffers, VkDeviceSize *offsets) noexcept;
     void bindIndexBuffer(VkBuffer buffer, const VkDeviceSize offset, const VkIndexType indexType) noexcept;
     void bindDescriptorSets(const VkPipelineBindPoint bindPoint, VkPipelineLayout pipelineLayout, uint32_t firstSet, uint32_t setCount, const VkDescriptorSet *sets, uint32_t dynamicOffsetCount = 0, const uint32_t *dynamicOffsets = nullptr);
+    // Descriptors of per-draw resources go into the command buffer, no set is allocated or written.
+    // The set number must have a push descriptor layout in the pipeline layout.
+    void pushDescriptorSet(const PushDescriptorCommands &commands, const VkPipelineBindPoint bindPoint, VkPipelineLayout pipelineLayout,
+        const uint32_t set, const std::vector<VkWriteDescriptorSet> &descriptorWrites) noexcept;
+    // The template is created with DescriptorUpdateTemplate::createForPushDescriptors().
+    void pushDescriptorSetWithTemplate(const PushDescriptorCommands &commands, VkDescriptorUpdateTemplate updateTemplate,
+        VkPipelineLayout pipelineLayout, const uint32_t set, const void *data) noexcept;
+    template <typename T>
+    inline void pushDescriptorSetWithTemplate(const PushDescriptorCommands &commands, VkDescriptorUpdateTemplate updateTemplate,
+        VkPipelineLayout pipelineLayout, const uint32_t set, const T &data) noexcept {
+        static_assert(std::is_trivially_copyable_v<T>, "Descriptor data must be a struct of descriptor infos");
+
+        pushDescriptorSetWithTemplate(commands, updateTemplate, pipelineLayout, set, static_cast<const void*>(&data));
+    }
+    void pushConstants(VkPipelineLayout pipelineLayout, const VkShaderStageFlags stageFlags, const uint32_t offset,
+        const uint32_t size, const void *values) noexcept;
+    // The value is copied into the command buffer, T has to match the push constant block of the shader.
+    template <typename T>
+    inline void pushConstants(VkPipelineLayout pipelineLayout, const VkShaderStageFlags stageFlags, const T &value,
+        const uint32_t offset = 0) noexcept {
+        static_assert(std::is_trivially_copyable_v<T>, "Push constants must be trivially copyable");
+        static_assert(sizeof(T) % 4 == 0, "Push constant size must be a multiple of 4");
+
+        pushConstants(pipelineLayout, stageFlags, offset, static_cast<uint32_t>(sizeof(T)), &value);
+    }
 
     void draw(const uint32_t vertexCount, const uint32_t instanceCount,
         const uint32_t firstVertex = 0, const uint32_t firstInstance = 0) noexcept;
     void drawIndexed(const uint32_t indexCount, const uint32_t instanceCount,
         const uint32_t firstIndex, const int32_t vertexOffset, const uint32_t firstInstance) noexcept;
+    void dispatch(const uint32_t groupCountX, const uint32_t groupCountY = 1, const uint32_t groupCountZ = 1) noexcept;
+    // The buffer holds VkDispatchIndirectCommand at the offset.
+    void dispatchIndirect(Buffer &buffer, const VkDeviceSize offset = 0) noexcept;
 
     void reset(const VkCommandPoolResetFlagBits flags);
     void setViewports(const std::vector<VkViewport> &vps, const uint32_t firstIndex, const uint32_t count) noexcept;
@@ -46,7 +96,22 @@ public:
         setScissors(scissors, 0, static_cast<uint32_t>(scissors.size()));
     }
 
+    // Extended dynamic state, valid if the bound pipeline has the state dynamic.
+    void setCullMode(const VkCullModeFlags cullMode) noexcept;
+    void setFrontFace(const VkFrontFace frontFace) noexcept;
+    void setPrimitiveTopology(const VkPrimitiveTopology topology) noexcept;
+    void setDepthTestEnable(const bool enable) noexcept;
+    void setDepthWriteEnable(const bool enable) noexcept;
+    void setDepthCompareOp(const VkCompareOp compareOp) noexcept;
+    void setDepthBiasEnable(const bool enable) noexcept;
+    void setRasterizerDiscardEnable(const bool enable) noexcept;
+    void setPrimitiveRestartEnable(const bool enable) noexcept;
+    void setColorBlendEnable(const ExtendedDynamicState3Commands &commands, const uint32_t firstAttachment,
+        const std::vector<VkBool32> &enables) noexcept;
+    void setPolygonMode(const ExtendedDynamicState3Commands &commands, const VkPolygonMode polygonMode) noexcept;
+
     void bindPipeline(VkPipeline pipeline, const VkPipelineBindPoint bindPoint) noexcept;
+    void executeCommands(const std::vector<VkCommandBuffer> &commandBuffers) noexcept;
 
 private:
     VkCommandBuffer _buf = VK_NULL_HANDLE;
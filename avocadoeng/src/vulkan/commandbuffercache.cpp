@@ -0,0 +1,75 @@
+#include "commandbuffercache.hpp"
+
+#include "logicaldevice.hpp"
+#include "vkutils.hpp"
+
+using namespace std::string_literals;
+
+namespace avocado::vulkan {
+
+CommandBufferCache::CommandBufferCache(LogicalDevice &device, VkCommandPool commandPool, const uint32_t slotCount):
+    _device(device),
+    _commandPool(commandPool),
+    _versions(slotCount, INVALID_VERSION),
+    _renderPasses(slotCount, VK_NULL_HANDLE) {
+    _commandBuffers = _device.allocateCommandBuffers(slotCount, _commandPool, VK_COMMAND_BUFFER_LEVEL_SECONDARY);
+    setHasError(_device.hasError());
+    if (hasError())
+        setErrorMessage("Can't allocate command buffers: "s + _device.getErrorMessage());
+}
+
+CommandBufferCache::~CommandBufferCache() {
+    if (_commandBuffers.empty())
+        return;
+
+    std::vector<VkCommandBuffer> handles = getCommandBufferHandles(_commandBuffers);
+    vkFreeCommandBuffers(_device.getHandle(), _commandPool, static_cast<uint32_t>(handles.size()), handles.data());
+}
+
+VkCommandBuffer CommandBufferCache::get(const uint32_t slot, const uint64_t version, VkRenderPass renderPass,
+    const uint32_t subpass, const RecordFunction &record) {
+    assert(slot < _commandBuffers.size());
+    assert(version != INVALID_VERSION);
+
+    CommandBuffer &commandBuffer = _commandBuffers[slot];
+    if (_versions[slot] == version && _renderPasses[slot] == renderPass)
+        return commandBuffer.getHandle();
+
+    commandBuffer.reset(static_cast<VkCommandPoolResetFlagBits>(0));
+    setHasError(commandBuffer.hasError());
+    if (hasError()) {
+        setErrorMessage("Can't reset command buffer: "s + commandBuffer.getErrorMessage());
+        return VK_NULL_HANDLE;
+    }
+
+    commandBuffer.beginSecondary(renderPass, subpass);
+    setHasError(commandBuffer.hasError());
+    if (hasError()) {
+        setErrorMessage("Can't begin command buffer: "s + commandBuffer.getErrorMessage());
+        return VK_NULL_HANDLE;
+    }
+
+    record(commandBuffer, slot);
+    commandBuffer.end();
+    setHasError(commandBuffer.hasError());
+    if (hasError()) {
+        setErrorMessage("Can't end command buffer: "s + commandBuffer.getErrorMessage());
+        _versions[slot] = INVALID_VERSION;
+        return VK_NULL_HANDLE;
+    }
+
+    _versions[slot] = version;
+    _renderPasses[slot] = renderPass;
+    ++_recordCount;
+    return commandBuffer.getHandle();
+}
+
+void CommandBufferCache::invalidate() noexcept {
+    std::fill(_versions.begin(), _versions.end(), INVALID_VERSION);
+}
+
+uint64_t CommandBufferCache::getRecordCount() const noexcept {
+    return _recordCount;
+}
+
+} // namespace avocado::vulkan.
@@ -0,0 +1,55 @@
+#ifndef AVOCADO_VULKAN_COMMAND_BUFFER_CACHE
+#define AVOCADO_VULKAN_COMMAND_BUFFER_CACHE
+
+#include "commandbuffer.hpp"
+
+#include "../errorstorage.hpp"
+#include "../utils.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <functional>
+#include <limits>
+#include <vector>
+
+namespace avocado::vulkan {
+
+class LogicalDevice;
+
+// Secondary command buffers which are recorded once and reused across frames while their content
+// version stays the same. There is one buffer per slot (usually per frame in flight), so a buffer is
+// re-recorded only when its slot is not used by the GPU. Per-frame data has to come through
+// per-slot descriptor sets, dynamic offsets or push constants.
+class CommandBufferCache: public core::ErrorStorage {
+public:
+    NON_COPYABLE(CommandBufferCache);
+    NON_MOVABLE(CommandBufferCache);
+
+    using RecordFunction = std::function<void(CommandBuffer &commandBuffer, const uint32_t slot)>;
+
+    // The command pool must allow resetting individual command buffers.
+    explicit CommandBufferCache(LogicalDevice &device, VkCommandPool commandPool, const uint32_t slotCount);
+    ~CommandBufferCache();
+
+    // Returns the command buffer of the slot. It is recorded only if the version differs from the recorded one.
+    VkCommandBuffer get(const uint32_t slot, const uint64_t version, VkRenderPass renderPass, const uint32_t subpass,
+        const RecordFunction &record);
+    // Forces re-recording of every slot.
+    void invalidate() noexcept;
+
+    uint64_t getRecordCount() const noexcept;
+
+private:
+    static constexpr uint64_t INVALID_VERSION = std::numeric_limits<uint64_t>::max();
+
+    LogicalDevice &_device;
+    VkCommandPool _commandPool = VK_NULL_HANDLE;
+    std::vector<CommandBuffer> _commandBuffers;
+    std::vector<uint64_t> _versions;
+    std::vector<VkRenderPass> _renderPasses;
+    uint64_t _recordCount = 0;
+};
+
+} // namespace avocado::vulkan.
+
+#endif
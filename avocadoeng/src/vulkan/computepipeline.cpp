@@ -0,0 +1,109 @@
+#include "computepipeline.hpp"
+
+#include "vkutils.hpp"
+
+using namespace std::string_literals;
+
+namespace avocado::vulkan {
+
+ComputePipelineBuilder::ComputePipelineBuilder(LogicalDevice &device):
+    _logicalDevice(device) {
+}
+
+VkPipelineLayout ComputePipelineBuilder::getPipelineLayout() noexcept {
+    return _pipelineLayout;
+}
+
+void ComputePipelineBuilder::setShaderModule(const SpirvView code) {
+    ShaderModuleCache &shaderModuleCache = _logicalDevice.getShaderModuleCache();
+    const uint64_t hash = shaderModuleCache.addCode(code);
+    setHasError(shaderModuleCache.hasError());
+    if (hasError()) {
+        setErrorMessage("Can't add shader module: "s + shaderModuleCache.getErrorMessage());
+        return;
+    }
+
+    _shaderModuleHash = hash;
+    _hasShaderModule = true;
+}
+
+void ComputePipelineBuilder::setShaderModuleFile(const std::string &filePath) {
+    ShaderModuleCache &shaderModuleCache = _logicalDevice.getShaderModuleCache();
+    const uint64_t hash = shaderModuleCache.addFile(filePath);
+    setHasError(shaderModuleCache.hasError());
+    if (hasError()) {
+        setErrorMessage("Can't add shader module: "s + shaderModuleCache.getErrorMessage());
+        return;
+    }
+
+    _shaderModuleHash = hash;
+    _hasShaderModule = true;
+}
+
+void ComputePipelineBuilder::setDescriptorSetLayouts(std::vector<VkDescriptorSetLayout> &layouts) {
+    _descriptorSetLayouts = layouts;
+}
+
+void ComputePipelineBuilder::addPushConstantRange(const uint32_t offset, const uint32_t size) {
+    setHasError(size == 0 || offset % 4 != 0 || size % 4 != 0);
+    if (hasError()) {
+        setErrorMessage("Push constant range offset and size must be multiples of 4");
+        return;
+    }
+
+    const uint32_t maxPushConstantsSize = _logicalDevice.getLimits().maxPushConstantsSize;
+    setHasError(offset >= maxPushConstantsSize || size > maxPushConstantsSize - offset);
+    if (hasError()) {
+        setErrorMessage("Push constant range exceeds maxPushConstantsSize "s + std::to_string(maxPushConstantsSize));
+        return;
+    }
+
+    _pushConstantRanges.push_back({VK_SHADER_STAGE_COMPUTE_BIT, offset, size});
+}
+
+PipelinePtr ComputePipelineBuilder::buildPipeline() {
+    setHasError(!_hasShaderModule);
+    if (hasError()) {
+        setErrorMessage("Compute shader module is not set");
+        return makeObjectPtr<VkPipeline>(_logicalDevice, VK_NULL_HANDLE);
+    }
+
+    PipelineRegistry &pipelineRegistry = _logicalDevice.getPipelineRegistry();
+    _pipelineLayout = pipelineRegistry.getPipelineLayout(_descriptorSetLayouts, _pushConstantRanges);
+    setHasError(pipelineRegistry.hasError());
+    if (hasError()) {
+        setErrorMessage("Can't get pipeline layout: "s + pipelineRegistry.getErrorMessage());
+        return makeObjectPtr<VkPipeline>(_logicalDevice, VK_NULL_HANDLE);
+    }
+
+    VkShaderModule shaderModule = VK_NULL_HANDLE;
+    VkResult result = _logicalDevice.getShaderModuleCache().getShaderModule(_shaderModuleHash, shaderModule);
+    setHasError(result != VK_SUCCESS);
+    if (hasError()) {
+        setErrorMessage("vkCreateShaderModule returned "s + getVkResultString(result));
+        return makeObjectPtr<VkPipeline>(_logicalDevice, VK_NULL_HANDLE);
+    }
+
+    VkComputePipelineCreateInfo pipelineCI{}; FILL_S_TYPE(pipelineCI);
+    FILL_S_TYPE(pipelineCI.stage);
+    pipelineCI.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    pipelineCI.stage.module = shaderModule;
+    pipelineCI.stage.pName = "main"; // Entry point.
+    pipelineCI.layout = _pipelineLayout;
+
+    PipelineCache &pipelineCache = _logicalDevice.getPipelineCache();
+    VkPipeline pipeline = VK_NULL_HANDLE;
+    result = vkCreateComputePipelines(_logicalDevice.getHandle(), pipelineCache.getHandle(), 1, &pipelineCI, nullptr, &pipeline);
+    if (result == VK_SUCCESS)
+        pipelineCache.notifyPipelineCreated();
+
+    setHasError(result != VK_SUCCESS);
+    if (hasError()) {
+        setErrorMessage("vkCreateComputePipelines returned "s + getVkResultString(result));
+        return makeObjectPtr<VkPipeline>(_logicalDevice, VK_NULL_HANDLE);
+    }
+
+    return makeObjectPtr(_logicalDevice, pipeline);
+}
+
+} // namespace avocado::vulkan.
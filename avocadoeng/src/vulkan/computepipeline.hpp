@@ -0,0 +1,43 @@
+#ifndef AVOCADO_VULKAN_COMPUTE_PIPELINE
+#define AVOCADO_VULKAN_COMPUTE_PIPELINE
+
+#include "../errorstorage.hpp"
+
+#include "logicaldevice.hpp"
+#include "pointertypes.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <string>
+#include <vector>
+
+namespace avocado::vulkan {
+
+class ComputePipelineBuilder: public avocado::core::ErrorStorage {
+public:
+    explicit ComputePipelineBuilder(LogicalDevice &device);
+
+    VkPipelineLayout getPipelineLayout() noexcept;
+    // The module comes from the shader module cache of the device.
+    void setShaderModule(const SpirvView code);
+    void setShaderModuleFile(const std::string &filePath);
+    void setDescriptorSetLayouts(std::vector<VkDescriptorSetLayout> &layouts);
+    // Offset and size are multiples of 4.
+    void addPushConstantRange(const uint32_t offset, const uint32_t size);
+
+    PipelinePtr buildPipeline();
+
+private:
+    LogicalDevice &_logicalDevice;
+    // Key of the module in the shader module cache.
+    uint64_t _shaderModuleHash = 0;
+    bool _hasShaderModule = false;
+    // Owned by the pipeline registry.
+    VkPipelineLayout _pipelineLayout = VK_NULL_HANDLE;
+    std::vector<VkDescriptorSetLayout> _descriptorSetLayouts;
+    std::vector<VkPushConstantRange> _pushConstantRanges;
+};
+
+} // namespace avocado::vulkan.
+
+#endif
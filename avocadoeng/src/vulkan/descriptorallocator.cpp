@@ -0,0 +1,141 @@
+#include "descriptorallocator.hpp"
+
+#include "vkutils.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+using namespace std::string_literals;
+
+namespace avocado::vulkan {
+
+namespace {
+
+// Bigger pools would mostly stay empty.
+constexpr uint32_t maxSetsPerPool = 4096;
+
+} // namespace.
+
+DescriptorAllocator::DescriptorAllocator(VkDevice device, const std::vector<DescriptorPoolRatio> &ratios,
+    const uint32_t setsPerPool, const VkDescriptorPoolCreateFlags poolFlags):
+    _device(device),
+    _ratios(ratios),
+    _poolFlags(poolFlags),
+    _setsPerPool(std::max(setsPerPool, 1u)) {
+}
+
+DescriptorAllocator::~DescriptorAllocator() {
+    if (_currentPool != VK_NULL_HANDLE)
+        vkDestroyDescriptorPool(_device, _currentPool, nullptr);
+
+    for (VkDescriptorPool pool : _fullPools)
+        vkDestroyDescriptorPool(_device, pool, nullptr);
+
+    for (VkDescriptorPool pool : _freePools)
+        vkDestroyDescriptorPool(_device, pool, nullptr);
+}
+
+VkDescriptorSet DescriptorAllocator::allocate(VkDescriptorSetLayout layout, const void *pNext) {
+    if (_currentPool == VK_NULL_HANDLE) {
+        _currentPool = acquirePool();
+        if (_currentPool == VK_NULL_HANDLE)
+            return VK_NULL_HANDLE;
+    }
+
+    VkDescriptorSetAllocateInfo allocInfo{}; FILL_S_TYPE(allocInfo);
+    allocInfo.pNext = pNext;
+    allocInfo.descriptorPool = _currentPool;
+    allocInfo.descriptorSetCount = 1;
+    allocInfo.pSetLayouts = &layout;
+
+    VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+    VkResult result = vkAllocateDescriptorSets(_device, &allocInfo, &descriptorSet);
+    if (result == VK_ERROR_OUT_OF_POOL_MEMORY || result == VK_ERROR_FRAGMENTED_POOL) {
+        // A set which doesn't fit into a fresh pool is an error, so it's tried only once more.
+        _fullPools.push_back(_currentPool);
+        _currentPool = acquirePool();
+        if (_currentPool == VK_NULL_HANDLE)
+            return VK_NULL_HANDLE;
+
+        allocInfo.descriptorPool = _currentPool;
+        result = vkAllocateDescriptorSets(_device, &allocInfo, &descriptorSet);
+    }
+
+    setHasError(result != VK_SUCCESS);
+    if (hasError()) {
+        setErrorMessage("vkAllocateDescriptorSets returned "s + getVkResultString(result));
+        return VK_NULL_HANDLE;
+    }
+
+    return descriptorSet;
+}
+
+void DescriptorAllocator::reset() {
+    if (_currentPool != VK_NULL_HANDLE)
+        _fullPools.push_back(_currentPool);
+
+    _currentPool = VK_NULL_HANDLE;
+    for (VkDescriptorPool pool : _fullPools) {
+        const VkResult result = vkResetDescriptorPool(_device, pool, 0);
+        setHasError(result != VK_SUCCESS);
+        if (hasError()) {
+            setErrorMessage("vkResetDescriptorPool returned "s + getVkResultString(result));
+            return;
+        }
+
+        _freePools.push_back(pool);
+    }
+    _fullPools.clear();
+}
+
+size_t DescriptorAllocator::getPoolCount() const noexcept {
+    return _fullPools.size() + _freePools.size() + (_currentPool != VK_NULL_HANDLE ? 1 : 0);
+}
+
+const std::vector<DescriptorPoolRatio> &DescriptorAllocator::getDefaultRatios() noexcept {
+    static const std::vector<DescriptorPoolRatio> ratios {
+        {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 2.f},
+        {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 4.f},
+        {VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, 4.f},
+        {VK_DESCRIPTOR_TYPE_SAMPLER, 1.f},
+        {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1.f},
+        {VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1.f},
+        {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1.f}
+    };
+    return ratios;
+}
+
+VkDescriptorPool DescriptorAllocator::acquirePool() {
+    if (!_freePools.empty()) {
+        VkDescriptorPool pool = _freePools.back();
+        _freePools.pop_back();
+        return pool;
+    }
+
+    std::vector<VkDescriptorPoolSize> poolSizes;
+    poolSizes.reserve(_ratios.size());
+    for (const DescriptorPoolRatio &ratio : _ratios) {
+        const uint32_t descriptorCount = static_cast<uint32_t>(std::ceil(ratio.ratio * static_cast<float>(_setsPerPool)));
+        if (descriptorCount > 0)
+            poolSizes.push_back({ratio.type, descriptorCount});
+    }
+
+    VkDescriptorPoolCreateInfo poolCI{}; FILL_S_TYPE(poolCI);
+    poolCI.flags = _poolFlags;
+    poolCI.maxSets = _setsPerPool;
+    poolCI.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+    poolCI.pPoolSizes = poolSizes.data();
+
+    VkDescriptorPool pool = VK_NULL_HANDLE;
+    const VkResult result = vkCreateDescriptorPool(_device, &poolCI, nullptr, &pool);
+    setHasError(result != VK_SUCCESS);
+    if (hasError()) {
+        setErrorMessage("vkCreateDescriptorPool returned "s + getVkResultString(result));
+        return VK_NULL_HANDLE;
+    }
+
+    _setsPerPool = std::min(_setsPerPool * 2, maxSetsPerPool);
+    return pool;
+}
+
+} // namespace avocado::vulkan.
@@ -0,0 +1,56 @@
+#ifndef AVOCADO_VULKAN_DESCRIPTOR_ALLOCATOR
+#define AVOCADO_VULKAN_DESCRIPTOR_ALLOCATOR
+
+#include "../errorstorage.hpp"
+#include "../utils.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <vector>
+
+namespace avocado::vulkan {
+
+// Descriptors of the type a pool holds for each set it can allocate.
+struct DescriptorPoolRatio {
+    VkDescriptorType type;
+    float ratio;
+};
+
+// Allocates descriptor sets from a chain of pools. An exhausted pool is set aside and the next one,
+// twice as big up to a limit, is used instead. reset() frees all sets at once with vkResetDescriptorPool,
+// so transient sets cost no individual frees. Not thread safe.
+class DescriptorAllocator: public core::ErrorStorage {
+public:
+    NON_COPYABLE(DescriptorAllocator);
+    NON_MOVABLE(DescriptorAllocator);
+
+    DescriptorAllocator(VkDevice device, const std::vector<DescriptorPoolRatio> &ratios = getDefaultRatios(),
+        const uint32_t setsPerPool = 64, const VkDescriptorPoolCreateFlags poolFlags = 0);
+    ~DescriptorAllocator();
+
+    // pNext is passed to vkAllocateDescriptorSets, e.g. for variable descriptor counts.
+    VkDescriptorSet allocate(VkDescriptorSetLayout layout, const void *pNext = nullptr);
+    // Invalidates every set allocated since the last reset. The GPU must be done with them.
+    void reset();
+
+    size_t getPoolCount() const noexcept;
+
+    static const std::vector<DescriptorPoolRatio> &getDefaultRatios() noexcept;
+
+private:
+    VkDescriptorPool acquirePool();
+
+    VkDevice _device = VK_NULL_HANDLE;
+    std::vector<DescriptorPoolRatio> _ratios;
+    VkDescriptorPoolCreateFlags _poolFlags = 0;
+    // Size of the next created pool.
+    uint32_t _setsPerPool = 0;
+    VkDescriptorPool _currentPool = VK_NULL_HANDLE;
+    // Exhausted pools, reused after reset().
+    std::vector<VkDescriptorPool> _fullPools;
+    std::vector<VkDescriptorPool> _freePools;
+};
+
+} // namespace avocado::vulkan.
+
+#endif
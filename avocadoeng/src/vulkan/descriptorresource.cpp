@@ -0,0 +1,77 @@
+#include "descriptorresource.hpp"
+
+#include "../utils.hpp"
+
+#include <algorithm>
+
+namespace avocado::vulkan {
+
+DescriptorResource DescriptorResource::createBuffer(const uint32_t binding, const VkDescriptorType type, VkBuffer buffer,
+    const VkDeviceSize offset, const VkDeviceSize range) noexcept {
+    DescriptorResource resource;
+    resource.binding = binding;
+    resource.type = type;
+    resource.buffer = buffer;
+    resource.offset = offset;
+    resource.range = range;
+    return resource;
+}
+
+DescriptorResource DescriptorResource::createImage(const uint32_t binding, const VkDescriptorType type, VkImageView imageView,
+    VkSampler sampler, const VkImageLayout imageLayout) noexcept {
+    DescriptorResource resource;
+    resource.binding = binding;
+    resource.type = type;
+    resource.imageView = imageView;
+    resource.sampler = sampler;
+    resource.imageLayout = imageLayout;
+    return resource;
+}
+
+void DescriptorResource::normalize(std::vector<DescriptorResource> &resources) {
+    const auto isBefore = [](const DescriptorResource &lhs, const DescriptorResource &rhs) {
+        return (lhs.binding < rhs.binding || (lhs.binding == rhs.binding && lhs.arrayElement < rhs.arrayElement));
+    };
+    std::stable_sort(resources.begin(), resources.end(), isBefore);
+
+    // Keeps the last of equal elements, the stable sort left them in the listed order.
+    const auto isSameElement = [](const DescriptorResource &lhs, const DescriptorResource &rhs) {
+        return (lhs.binding == rhs.binding && lhs.arrayElement == rhs.arrayElement);
+    };
+    std::reverse(resources.begin(), resources.end());
+    resources.erase(std::unique(resources.begin(), resources.end(), isSameElement), resources.end());
+    std::reverse(resources.begin(), resources.end());
+}
+
+std::string DescriptorResource::createContentsKey(VkDescriptorSetLayout layout, const std::vector<DescriptorResource> &resources) {
+    // Fields are appended one by one, padding bytes of the struct would make equal contents differ.
+    std::string key;
+    utils::appendKeyBytes(key, layout);
+    for (const DescriptorResource &resource : resources) {
+        utils::appendKeyBytes(key, resource.binding);
+        utils::appendKeyBytes(key, resource.arrayElement);
+        utils::appendKeyBytes(key, resource.type);
+        utils::appendKeyBytes(key, resource.buffer);
+        utils::appendKeyBytes(key, resource.offset);
+        utils::appendKeyBytes(key, resource.range);
+        utils::appendKeyBytes(key, resource.imageView);
+        utils::appendKeyBytes(key, resource.sampler);
+        utils::appendKeyBytes(key, resource.imageLayout);
+    }
+
+    return key;
+}
+
+std::string DescriptorResource::createSlotsKey(VkDescriptorSetLayout layout, const std::vector<DescriptorResource> &resources) {
+    std::string key;
+    utils::appendKeyBytes(key, layout);
+    for (const DescriptorResource &resource : resources) {
+        utils::appendKeyBytes(key, resource.binding);
+        utils::appendKeyBytes(key, resource.arrayElement);
+        utils::appendKeyBytes(key, resource.type);
+    }
+
+    return key;
+}
+
+} // namespace avocado::vulkan.
@@ -0,0 +1,39 @@
+#ifndef AVOCADO_VULKAN_DESCRIPTOR_RESOURCE
+#define AVOCADO_VULKAN_DESCRIPTOR_RESOURCE
+
+#include <vulkan/vulkan_core.h>
+
+#include <string>
+#include <vector>
+
+namespace avocado::vulkan {
+
+// One array element of a binding. Handles which the descriptor type doesn't use stay VK_NULL_HANDLE.
+struct DescriptorResource {
+    uint32_t binding = 0;
+    uint32_t arrayElement = 0;
+    VkDescriptorType type = VK_DESCRIPTOR_TYPE_MAX_ENUM;
+    VkBuffer buffer = VK_NULL_HANDLE;
+    VkDeviceSize offset = 0;
+    VkDeviceSize range = 0;
+    VkImageView imageView = VK_NULL_HANDLE;
+    VkSampler sampler = VK_NULL_HANDLE;
+    VkImageLayout imageLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+    static DescriptorResource createBuffer(const uint32_t binding, const VkDescriptorType type, VkBuffer buffer,
+        const VkDeviceSize offset = 0, const VkDeviceSize range = VK_WHOLE_SIZE) noexcept;
+    static DescriptorResource createImage(const uint32_t binding, const VkDescriptorType type, VkImageView imageView,
+        VkSampler sampler, const VkImageLayout imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL) noexcept;
+
+    // Orders by binding and array element, so the order resources are listed in doesn't change keys.
+    // Of duplicated elements the last listed one is kept, as it would win when written.
+    static void normalize(std::vector<DescriptorResource> &resources);
+    // Keys of normalized resources. Equal contents keys mean equal descriptors, equal slots keys mean
+    // the same array elements are written, so a set written with one overwrites everything the other wrote.
+    static std::string createContentsKey(VkDescriptorSetLayout layout, const std::vector<DescriptorResource> &resources);
+    static std::string createSlotsKey(VkDescriptorSetLayout layout, const std::vector<DescriptorResource> &resources);
+};
+
+} // namespace avocado::vulkan.
+
+#endif
@@ -0,0 +1,116 @@
+#include "descriptorsetcache.hpp"
+
+#include "vkutils.hpp"
+
+#include <algorithm>
+
+using namespace std::string_literals;
+
+namespace avocado::vulkan {
+
+DescriptorSetCache::DescriptorSetCache(VkDevice device, const std::vector<DescriptorPoolRatio> &ratios):
+    _device(device),
+    _allocator(device, ratios) {
+}
+
+VkDescriptorSet DescriptorSetCache::get(VkDescriptorSetLayout layout, std::vector<DescriptorResource> resources) {
+    DescriptorResource::normalize(resources);
+    std::string key = DescriptorResource::createContentsKey(layout, resources);
+
+    std::lock_guard lock(_mutex);
+    setHasError(false);
+    const auto it = _entries.find(key);
+    if (it != _entries.end())
+        return it->second.descriptorSet;
+
+    Entry entry;
+    entry.slotsKey = DescriptorResource::createSlotsKey(layout, resources);
+    entry.descriptorSet = acquireDescriptorSet(layout, entry.slotsKey);
+    if (entry.descriptorSet == VK_NULL_HANDLE)
+        return VK_NULL_HANDLE;
+
+    writeDescriptorSet(entry.descriptorSet, resources);
+
+    entry.resources = std::move(resources);
+    const VkDescriptorSet descriptorSet = entry.descriptorSet;
+    _entries.emplace(std::move(key), std::move(entry));
+    return descriptorSet;
+}
+
+void DescriptorSetCache::invalidateBuffer(VkBuffer buffer) {
+    invalidate([buffer](const DescriptorResource &resource) { return resource.buffer == buffer; });
+}
+
+void DescriptorSetCache::invalidateImageView(VkImageView imageView) {
+    invalidate([imageView](const DescriptorResource &resource) { return resource.imageView == imageView; });
+}
+
+void DescriptorSetCache::invalidateSampler(VkSampler sampler) {
+    invalidate([sampler](const DescriptorResource &resource) { return resource.sampler == sampler; });
+}
+
+size_t DescriptorSetCache::getCachedCount() const {
+    std::lock_guard lock(_mutex);
+    return _entries.size();
+}
+
+VkDescriptorSet DescriptorSetCache::acquireDescriptorSet(VkDescriptorSetLayout layout, const std::string &slotsKey) {
+    std::vector<VkDescriptorSet> &freeDescriptorSets = _freeDescriptorSets[slotsKey];
+    if (!freeDescriptorSets.empty()) {
+        VkDescriptorSet descriptorSet = freeDescriptorSets.back();
+        freeDescriptorSets.pop_back();
+        return descriptorSet;
+    }
+
+    VkDescriptorSet descriptorSet = _allocator.allocate(layout);
+    setHasError(_allocator.hasError());
+    if (hasError())
+        setErrorMessage("Can't allocate cached descriptor set: "s + _allocator.getErrorMessage());
+
+    return descriptorSet;
+}
+
+void DescriptorSetCache::writeDescriptorSet(VkDescriptorSet descriptorSet, const std::vector<DescriptorResource> &resources) {
+    // Reserved, so the writes can point into them.
+    std::vector<VkDescriptorBufferInfo> bufferInfos;
+    bufferInfos.reserve(resources.size());
+    std::vector<VkDescriptorImageInfo> imageInfos;
+    imageInfos.reserve(resources.size());
+
+    std::vector<VkWriteDescriptorSet> descriptorWrites;
+    descriptorWrites.reserve(resources.size());
+    for (const DescriptorResource &resource : resources) {
+        VkWriteDescriptorSet descriptorWrite{}; FILL_S_TYPE(descriptorWrite);
+        descriptorWrite.dstSet = descriptorSet;
+        descriptorWrite.dstBinding = resource.binding;
+        descriptorWrite.dstArrayElement = resource.arrayElement;
+        descriptorWrite.descriptorCount = 1;
+        descriptorWrite.descriptorType = resource.type;
+        if (resource.buffer != VK_NULL_HANDLE) {
+            bufferInfos.push_back({resource.buffer, resource.offset, resource.range});
+            descriptorWrite.pBufferInfo = &bufferInfos.back();
+        } else {
+            imageInfos.push_back({resource.sampler, resource.imageView, resource.imageLayout});
+            descriptorWrite.pImageInfo = &imageInfos.back();
+        }
+        descriptorWrites.push_back(descriptorWrite);
+    }
+
+    vkUpdateDescriptorSets(_device, static_cast<uint32_t>(descriptorWrites.size()), descriptorWrites.data(), 0, nullptr);
+}
+
+template <typename Predicate>
+void DescriptorSetCache::invalidate(Predicate isReferenced) {
+    std::lock_guard lock(_mutex);
+    for (auto it = _entries.begin(); it != _entries.end();) {
+        const Entry &entry = it->second;
+        if (std::any_of(entry.resources.begin(), entry.resources.end(), isReferenced)) {
+            _freeDescriptorSets[entry.slotsKey].push_back(entry.descriptorSet);
+            it = _entries.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+} // namespace avocado::vulkan.
@@ -0,0 +1,66 @@
+#ifndef AVOCADO_VULKAN_DESCRIPTOR_SET_CACHE
+#define AVOCADO_VULKAN_DESCRIPTOR_SET_CACHE
+
+#include "descriptorallocator.hpp"
+#include "descriptorresource.hpp"
+
+#include "../errorstorage.hpp"
+#include "../utils.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace avocado::vulkan {
+
+// Descriptor sets keyed by their layout and the resources written into them. Asking for the same
+// contents again returns the set which already has them, so static materials are written only once.
+// Sets live until a resource they reference is invalidated. The logical device owns one and invalidates
+// it when buffers, image views and samplers are destroyed, which may happen on any thread.
+// Error state belongs to the thread which calls get().
+class DescriptorSetCache: public core::ErrorStorage {
+public:
+    NON_COPYABLE(DescriptorSetCache);
+    NON_MOVABLE(DescriptorSetCache);
+
+    explicit DescriptorSetCache(VkDevice device, const std::vector<DescriptorPoolRatio> &ratios = DescriptorAllocator::getDefaultRatios());
+
+    // Allocates and writes a set only if no set has these contents yet. The order of resources doesn't matter.
+    // Every array element the layout has should be given, elements which aren't keep their old descriptors.
+    VkDescriptorSet get(VkDescriptorSetLayout layout, std::vector<DescriptorResource> resources);
+
+    // Call when the resource is destroyed. The GPU is done with it by then, so the sets which
+    // referenced it are rewritten with other contents later instead of being allocated again.
+    void invalidateBuffer(VkBuffer buffer);
+    void invalidateImageView(VkImageView imageView);
+    void invalidateSampler(VkSampler sampler);
+
+    size_t getCachedCount() const;
+
+private:
+    struct Entry {
+        VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+        std::string slotsKey;
+        std::vector<DescriptorResource> resources;
+    };
+
+    VkDescriptorSet acquireDescriptorSet(VkDescriptorSetLayout layout, const std::string &slotsKey);
+    void writeDescriptorSet(VkDescriptorSet descriptorSet, const std::vector<DescriptorResource> &resources);
+    template <typename Predicate>
+    void invalidate(Predicate isReferenced);
+
+    VkDevice _device = VK_NULL_HANDLE;
+    mutable std::mutex _mutex;
+    DescriptorAllocator _allocator;
+    std::unordered_map<std::string, Entry> _entries;
+    // Sets of invalidated entries by their slots key. A set is reused only for the same array elements,
+    // so no descriptor of the previous contents survives the rewrite.
+    std::unordered_map<std::string, std::vector<VkDescriptorSet>> _freeDescriptorSets;
+};
+
+} // namespace avocado::vulkan.
+
+#endif
@@ -0,0 +1,86 @@
+#include "descriptorupdatetemplate.hpp"
+
+#include "vkutils.hpp"
+
+#include <cassert>
+
+using namespace std::string_literals;
+
+namespace avocado::vulkan {
+
+DescriptorUpdateTemplate::DescriptorUpdateTemplate(VkDevice device):
+    _device(device) {
+}
+
+DescriptorUpdateTemplate::~DescriptorUpdateTemplate() {
+    if (_updateTemplate != VK_NULL_HANDLE)
+        vkDestroyDescriptorUpdateTemplate(_device, _updateTemplate, nullptr);
+}
+
+void DescriptorUpdateTemplate::addEntry(const uint32_t binding, const VkDescriptorType type, const size_t offset,
+    const uint32_t descriptorCount, const size_t stride, const uint32_t arrayElement) {
+    VkDescriptorUpdateTemplateEntry entry{};
+    entry.dstBinding = binding;
+    entry.dstArrayElement = arrayElement;
+    entry.descriptorCount = descriptorCount;
+    entry.descriptorType = type;
+    entry.offset = offset;
+    entry.stride = (stride != 0 ? stride : getDescriptorInfoSize(type));
+    _entries.push_back(entry);
+}
+
+void DescriptorUpdateTemplate::create(VkDescriptorSetLayout layout) {
+    VkDescriptorUpdateTemplateCreateInfo templateCI{}; FILL_S_TYPE(templateCI);
+    templateCI.templateType = VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_DESCRIPTOR_SET;
+    templateCI.descriptorSetLayout = layout;
+    createTemplate(templateCI);
+}
+
+void DescriptorUpdateTemplate::createForPushDescriptors(const VkPipelineBindPoint bindPoint, VkPipelineLayout pipelineLayout, const uint32_t set) {
+    VkDescriptorUpdateTemplateCreateInfo templateCI{}; FILL_S_TYPE(templateCI);
+    templateCI.templateType = VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_PUSH_DESCRIPTORS_KHR;
+    templateCI.pipelineBindPoint = bindPoint;
+    templateCI.pipelineLayout = pipelineLayout;
+    templateCI.set = set;
+    createTemplate(templateCI);
+}
+
+VkDescriptorUpdateTemplate DescriptorUpdateTemplate::getHandle() noexcept {
+    return _updateTemplate;
+}
+
+void DescriptorUpdateTemplate::update(VkDescriptorSet descriptorSet, const void *data) noexcept {
+    assert(_updateTemplate != VK_NULL_HANDLE);
+
+    vkUpdateDescriptorSetWithTemplate(_device, descriptorSet, _updateTemplate, data);
+}
+
+void DescriptorUpdateTemplate::createTemplate(VkDescriptorUpdateTemplateCreateInfo &templateCI) {
+    assert(_updateTemplate == VK_NULL_HANDLE);
+
+    templateCI.descriptorUpdateEntryCount = static_cast<uint32_t>(_entries.size());
+    templateCI.pDescriptorUpdateEntries = _entries.data();
+
+    const VkResult result = vkCreateDescriptorUpdateTemplate(_device, &templateCI, nullptr, &_updateTemplate);
+    setHasError(result != VK_SUCCESS);
+    if (hasError())
+        setErrorMessage("vkCreateDescriptorUpdateTemplate returned "s + getVkResultString(result));
+}
+
+size_t DescriptorUpdateTemplate::getDescriptorInfoSize(const VkDescriptorType type) noexcept {
+    switch (type) {
+    case VK_DESCRIPTOR_TYPE_SAMPLER:
+    case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER:
+    case VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE:
+    case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
+    case VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT:
+        return sizeof(VkDescriptorImageInfo);
+    case VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER:
+    case VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER:
+        return sizeof(VkBufferView);
+    default:
+        return sizeof(VkDescriptorBufferInfo);
+    }
+}
+
+} // namespace avocado::vulkan.
@@ -0,0 +1,56 @@
+#ifndef AVOCADO_VULKAN_DESCRIPTOR_UPDATE_TEMPLATE
+#define AVOCADO_VULKAN_DESCRIPTOR_UPDATE_TEMPLATE
+
+#include "../errorstorage.hpp"
+#include "../utils.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <type_traits>
+#include <vector>
+
+namespace avocado::vulkan {
+
+// Writes all descriptors of a set from one packed struct, the driver reads the descriptor infos
+// at the entry offsets, so no VkWriteDescriptorSet arrays are built per update:
+//     struct MaterialDescriptors { VkDescriptorBufferInfo ubo; VkDescriptorImageInfo texture; };
+//     updateTemplate.addEntry(0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, offsetof(MaterialDescriptors, ubo));
+class DescriptorUpdateTemplate: public core::ErrorStorage {
+public:
+    NON_COPYABLE(DescriptorUpdateTemplate);
+    NON_MOVABLE(DescriptorUpdateTemplate);
+
+    explicit DescriptorUpdateTemplate(VkDevice device);
+    ~DescriptorUpdateTemplate();
+
+    // Array elements are stride bytes apart in the struct, 0 means they are packed.
+    void addEntry(const uint32_t binding, const VkDescriptorType type, const size_t offset,
+        const uint32_t descriptorCount = 1, const size_t stride = 0, const uint32_t arrayElement = 0);
+    // Sets updated with the template must have this layout.
+    void create(VkDescriptorSetLayout layout);
+    // For CommandBuffer::pushDescriptorSetWithTemplate(), the set of the pipeline layout is a push descriptor layout.
+    void createForPushDescriptors(const VkPipelineBindPoint bindPoint, VkPipelineLayout pipelineLayout, const uint32_t set);
+    VkDescriptorUpdateTemplate getHandle() noexcept;
+
+    void update(VkDescriptorSet descriptorSet, const void *data) noexcept;
+    template <typename T>
+    inline void update(VkDescriptorSet descriptorSet, const T &data) noexcept {
+        static_assert(std::is_trivially_copyable_v<T>, "Descriptor data must be a struct of descriptor infos");
+
+        update(descriptorSet, static_cast<const void*>(&data));
+    }
+
+    // Size of the info struct the driver reads for the type.
+    static size_t getDescriptorInfoSize(const VkDescriptorType type) noexcept;
+
+private:
+    void createTemplate(VkDescriptorUpdateTemplateCreateInfo &templateCI);
+
+    VkDevice _device = VK_NULL_HANDLE;
+    VkDescriptorUpdateTemplate _updateTemplate = VK_NULL_HANDLE;
+    std::vector<VkDescriptorUpdateTemplateEntry> _entries;
+};
+
+} // namespace avocado::vulkan.
+
+#endif
@@ -0,0 +1,85 @@
+#include "fencepool.hpp"
+
+#include "vkutils.hpp"
+
+#include <algorithm>
+#include <limits>
+
+using namespace std::string_literals;
+
+namespace avocado::vulkan {
+
+FencePool::FencePool(VkDevice device):
+    _device(device) {
+}
+
+FencePool::~FencePool() {
+    // Fences can't be destroyed while a pending submission still references them.
+    if (!_pendingFences.empty())
+        vkWaitForFences(_device, static_cast<uint32_t>(_pendingFences.size()), _pendingFences.data(), VK_TRUE, std::numeric_limits<uint64_t>::max());
+
+    for (VkFence fence : _fences)
+        vkDestroyFence(_device, fence, nullptr);
+}
+
+VkFence FencePool::acquire() {
+    if (_freeFences.empty())
+        collect();
+
+    if (!_freeFences.empty()) {
+        VkFence fence = _freeFences.back();
+        _freeFences.pop_back();
+        return fence;
+    }
+
+    VkFenceCreateInfo fenceCI{}; FILL_S_TYPE(fenceCI);
+    VkFence fence = VK_NULL_HANDLE;
+    const VkResult result = vkCreateFence(_device, &fenceCI, nullptr, &fence);
+    setHasError(result != VK_SUCCESS);
+    if (hasError()) {
+        setErrorMessage("vkCreateFence returned "s + getVkResultString(result));
+        return VK_NULL_HANDLE;
+    }
+
+    _fences.push_back(fence);
+    return fence;
+}
+
+void FencePool::release(VkFence fence, const bool isSubmitted) {
+    if (fence == VK_NULL_HANDLE)
+        return;
+
+    if (isSubmitted)
+        _pendingFences.push_back(fence);
+    else
+        _freeFences.push_back(fence);
+}
+
+void FencePool::collect() noexcept {
+    if (_pendingFences.empty())
+        return;
+
+    // Signaled fences are moved to the front and reset with one call.
+    auto pendingIt = std::partition(_pendingFences.begin(), _pendingFences.end(), [this](VkFence fence) {
+        return (vkGetFenceStatus(_device, fence) == VK_SUCCESS);
+    });
+    if (pendingIt == _pendingFences.begin())
+        return;
+
+    const std::vector<VkFence> signaledFences(_pendingFences.begin(), pendingIt);
+    const VkResult result = vkResetFences(_device, static_cast<uint32_t>(signaledFences.size()), signaledFences.data());
+    setHasError(result != VK_SUCCESS);
+    if (hasError()) {
+        setErrorMessage("vkResetFences returned "s + getVkResultString(result));
+        return;
+    }
+
+    _pendingFences.erase(_pendingFences.begin(), pendingIt);
+    _freeFences.insert(_freeFences.end(), signaledFences.begin(), signaledFences.end());
+}
+
+size_t FencePool::getCreatedCount() const noexcept {
+    return _fences.size();
+}
+
+} // namespace avocado::vulkan.
@@ -0,0 +1,42 @@
+#ifndef AVOCADO_VULKAN_FENCE_POOL
+#define AVOCADO_VULKAN_FENCE_POOL
+
+#include "../errorstorage.hpp"
+#include "../utils.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <vector>
+
+namespace avocado::vulkan {
+
+// Hands out unsignaled fences and recycles released ones once they are signaled,
+// so one-shot operations don't create and destroy a driver object each time.
+// Not thread safe.
+class FencePool: public core::ErrorStorage {
+public:
+    NON_COPYABLE(FencePool);
+    NON_MOVABLE(FencePool);
+
+    explicit FencePool(VkDevice device);
+    ~FencePool();
+
+    // Returns an unsignaled fence. A new one is created only if nothing can be recycled.
+    VkFence acquire();
+    // Gives the fence back to the pool. Submitted fences are reused after they are signaled.
+    void release(VkFence fence, const bool isSubmitted = true);
+    // Resets signaled released fences and makes them available again.
+    void collect() noexcept;
+
+    size_t getCreatedCount() const noexcept;
+
+private:
+    VkDevice _device = VK_NULL_HANDLE;
+    std::vector<VkFence> _fences;
+    std::vector<VkFence> _freeFences;
+    std::vector<VkFence> _pendingFences;
+};
+
+} // namespace avocado::vulkan.
+
+#endif
@@ -0,0 +1,39 @@
+#include "framedescriptorallocator.hpp"
+
+#include <cassert>
+
+using namespace std::string_literals;
+
+namespace avocado::vulkan {
+
+FrameDescriptorAllocator::FrameDescriptorAllocator(VkDevice device, const uint32_t framesInFlight,
+    const std::vector<DescriptorPoolRatio> &ratios, const uint32_t setsPerPool) {
+    assert(framesInFlight > 0);
+
+    _allocators.reserve(framesInFlight);
+    for (uint32_t i = 0; i < framesInFlight; ++i)
+        _allocators.push_back(std::make_unique<DescriptorAllocator>(device, ratios, setsPerPool));
+}
+
+void FrameDescriptorAllocator::beginFrame(const uint32_t frameIndex) {
+    assert(frameIndex < _allocators.size());
+
+    _frameIndex = frameIndex;
+    DescriptorAllocator &allocator = *_allocators[_frameIndex];
+    allocator.reset();
+    setHasError(allocator.hasError());
+    if (hasError())
+        setErrorMessage("Can't reset frame descriptor pools: "s + allocator.getErrorMessage());
+}
+
+VkDescriptorSet FrameDescriptorAllocator::allocate(VkDescriptorSetLayout layout, const void *pNext) {
+    DescriptorAllocator &allocator = *_allocators[_frameIndex];
+    VkDescriptorSet descriptorSet = allocator.allocate(layout, pNext);
+    setHasError(allocator.hasError());
+    if (hasError())
+        setErrorMessage("Can't allocate frame descriptor set: "s + allocator.getErrorMessage());
+
+    return descriptorSet;
+}
+
+} // namespace avocado::vulkan.
@@ -0,0 +1,38 @@
+#ifndef AVOCADO_VULKAN_FRAME_DESCRIPTOR_ALLOCATOR
+#define AVOCADO_VULKAN_FRAME_DESCRIPTOR_ALLOCATOR
+
+#include "descriptorallocator.hpp"
+
+#include "../errorstorage.hpp"
+#include "../utils.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <memory>
+#include <vector>
+
+namespace avocado::vulkan {
+
+// Descriptor sets which live for one frame. Each frame slot has its own allocator, whose pools are
+// reset as a whole when the slot is reused. Call beginFrame() after FrameScheduler::beginFrame(),
+// which waits until the previous frame of the slot is retired. Not thread safe.
+class FrameDescriptorAllocator: public core::ErrorStorage {
+public:
+    NON_COPYABLE(FrameDescriptorAllocator);
+    NON_MOVABLE(FrameDescriptorAllocator);
+
+    FrameDescriptorAllocator(VkDevice device, const uint32_t framesInFlight,
+        const std::vector<DescriptorPoolRatio> &ratios = DescriptorAllocator::getDefaultRatios(), const uint32_t setsPerPool = 64);
+
+    // Frees the sets allocated the last time the slot was used.
+    void beginFrame(const uint32_t frameIndex);
+    VkDescriptorSet allocate(VkDescriptorSetLayout layout, const void *pNext = nullptr);
+
+private:
+    std::vector<std::unique_ptr<DescriptorAllocator>> _allocators;
+    uint32_t _frameIndex = 0;
+};
+
+} // namespace avocado::vulkan.
+
+#endif
@@ -0,0 +1,187 @@
+#include "framescheduler.hpp"
+
+#include "logicaldevice.hpp"
+#include "queue.hpp"
+#include "submissionbuilder.hpp"
+#include "vkutils.hpp"
+
+using namespace std::string_literals;
+
+namespace avocado::vulkan {
+
+FrameScheduler::FrameScheduler(LogicalDevice &device, const uint32_t framesInFlight):
+    _device(device),
+    _timeline(device.createObjectPointer<VkSemaphore>(VK_NULL_HANDLE)),
+    _framesInFlight(framesInFlight) {
+    assert(framesInFlight > 0);
+
+    _timeline.reset(_device.createTimelineSemaphore(0));
+    setHasError(_device.hasError());
+    if (hasError()) {
+        setErrorMessage("Can't create timeline semaphore: "s + _device.getErrorMessage());
+        return;
+    }
+
+    _renderFinishedSemaphores.reserve(_framesInFlight);
+    for (uint32_t i = 0; i < _framesInFlight; ++i) {
+        _renderFinishedSemaphores.push_back(_device.createObjectPointer(_device.createSemaphore()));
+        setHasError(_device.hasError());
+        if (hasError()) {
+            setErrorMessage("Can't create semaphore: "s + _device.getErrorMessage());
+            return;
+        }
+    }
+}
+
+FrameScheduler::~FrameScheduler() {
+    // Semaphores can't be destroyed while pending submissions still reference them.
+    if (_submittedFrameNumber > 0)
+        waitIdle();
+
+    collectRetired(std::numeric_limits<uint64_t>::max());
+}
+
+void FrameScheduler::beginFrame() {
+    ++_frameNumber;
+
+    // Frame N reuses the resources of frame N - framesInFlight.
+    if (_frameNumber > _framesInFlight) {
+        waitForFrame(_frameNumber - _framesInFlight);
+        if (hasError())
+            return;
+    }
+
+    const uint64_t completedFrameNumber = getCompletedFrameNumber();
+    if (hasError())
+        return;
+
+    collectRetired(completedFrameNumber);
+    _device.getFencePool().collect();
+
+    // The submission of this frame waits for the semaphore, so it is unsignaled again once the frame is done.
+    _imageAvailableSemaphore = acquireSemaphore();
+}
+
+void FrameScheduler::addWaitSemaphore(VkSemaphore semaphore, const VkPipelineStageFlags2 waitStages, const uint64_t value) {
+    _waitSemaphores.push_back(semaphore);
+    _waitStages.push_back(waitStages);
+    _waitValues.push_back(value);
+}
+
+void FrameScheduler::submit(Queue &queue, VkCommandBuffer commandBuffer, const VkPipelineStageFlags2 waitStage) {
+    SubmissionBuilder submission;
+    submit(queue, submission, {commandBuffer}, waitStage);
+}
+
+void FrameScheduler::submit(Queue &queue, SubmissionBuilder &submission, const std::vector<VkCommandBuffer> &commandBuffers,
+    const VkPipelineStageFlags2 waitStage) {
+    assert(_frameNumber > 0);
+
+    addWaitSemaphore(getImageAvailableSemaphore(), waitStage);
+
+    submission.nextBatch();
+    for (size_t i = 0; i < _waitSemaphores.size(); ++i)
+        submission.addWaitSemaphore(_waitSemaphores[i], _waitStages[i], _waitValues[i]);
+    for (VkCommandBuffer commandBuffer : commandBuffers)
+        submission.addCommandBuffer(commandBuffer);
+
+    // A signal covers all earlier work in submission order, so the timeline value also retires the other batches.
+    submission.addSignalSemaphore(getRenderFinishedSemaphore(), VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT);
+    submission.addSignalSemaphore(_timeline.get(), VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, _frameNumber);
+
+    queue.submit(submission);
+    _waitSemaphores.clear();
+    _waitStages.clear();
+    _waitValues.clear();
+    setHasError(queue.hasError());
+    if (hasError()) {
+        setErrorMessage("Can't submit frame: "s + queue.getErrorMessage());
+        return;
+    }
+
+    _submittedFrameNumber = _frameNumber;
+}
+
+void FrameScheduler::retire(std::function<void()> callback) {
+    _retired.emplace_back(_frameNumber, std::move(callback));
+}
+
+VkSemaphore FrameScheduler::acquireSemaphore() {
+    SemaphorePool &semaphorePool = _device.getSemaphorePool();
+    VkSemaphore semaphore = semaphorePool.acquire();
+    setHasError(semaphorePool.hasError());
+    if (hasError()) {
+        setErrorMessage("Can't acquire semaphore: "s + semaphorePool.getErrorMessage());
+        return VK_NULL_HANDLE;
+    }
+
+    retire([&semaphorePool, semaphore]() {
+        semaphorePool.release(semaphore);
+    });
+    return semaphore;
+}
+
+uint32_t FrameScheduler::getFramesInFlight() const noexcept {
+    return _framesInFlight;
+}
+
+uint32_t FrameScheduler::getFrameIndex() const noexcept {
+    assert(_frameNumber > 0);
+
+    return static_cast<uint32_t>((_frameNumber - 1) % _framesInFlight);
+}
+
+uint64_t FrameScheduler::getFrameNumber() const noexcept {
+    return _frameNumber;
+}
+
+uint64_t FrameScheduler::getCompletedFrameNumber() noexcept {
+    const uint64_t value = _device.getSemaphoreCounterValue(_timeline.get());
+    setHasError(_device.hasError());
+    if (hasError())
+        setErrorMessage("Can't get timeline value: "s + _device.getErrorMessage());
+
+    return value;
+}
+
+bool FrameScheduler::isFrameComplete(const uint64_t frameNumber) noexcept {
+    return (getCompletedFrameNumber() >= frameNumber);
+}
+
+bool FrameScheduler::waitForFrame(const uint64_t frameNumber, const uint64_t timeout) noexcept {
+    const bool isComplete = _device.waitForSemaphore(_timeline.get(), frameNumber, timeout);
+    setHasError(_device.hasError());
+    if (hasError())
+        setErrorMessage("Can't wait for frame: "s + _device.getErrorMessage());
+
+    return isComplete;
+}
+
+void FrameScheduler::waitIdle() noexcept {
+    if (waitForFrame(_submittedFrameNumber))
+        collectRetired(_submittedFrameNumber);
+}
+
+VkSemaphore FrameScheduler::getTimeline() noexcept {
+    return _timeline.get();
+}
+
+VkSemaphore FrameScheduler::getImageAvailableSemaphore() noexcept {
+    assert(_imageAvailableSemaphore != VK_NULL_HANDLE);
+
+    return _imageAvailableSemaphore;
+}
+
+VkSemaphore FrameScheduler::getRenderFinishedSemaphore() noexcept {
+    return _renderFinishedSemaphores[getFrameIndex()].get();
+}
+
+void FrameScheduler::collectRetired(const uint64_t completedFrameNumber) {
+    // Callbacks are queued in frame order.
+    while (!_retired.empty() && _retired.front().first <= completedFrameNumber) {
+        _retired.front().second();
+        _retired.pop_front();
+    }
+}
+
+} // namespace avocado::vulkan.
@@ -0,0 +1,85 @@
+#ifndef AVOCADO_VULKAN_FRAME_SCHEDULER
+#define AVOCADO_VULKAN_FRAME_SCHEDULER
+
+#include "pointertypes.hpp"
+
+#include "../errorstorage.hpp"
+#include "../utils.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <deque>
+#include <functional>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace avocado::vulkan {
+
+class LogicalDevice;
+class Queue;
+class SubmissionBuilder;
+
+// Paces frames with a single timeline semaphore. Frame N signals value N on the GPU timeline
+// when its submission completes, so "frame N is done" can be queried or waited for from any
+// place on the CPU without per-frame fences.
+class FrameScheduler: public core::ErrorStorage {
+public:
+    NON_COPYABLE(FrameScheduler);
+    NON_MOVABLE(FrameScheduler);
+
+    explicit FrameScheduler(LogicalDevice &device, const uint32_t framesInFlight);
+    ~FrameScheduler();
+
+    // Starts the next frame. Blocks until the frame which used the same slot is retired.
+    // The image available semaphore of the frame comes from the device pool.
+    void beginFrame();
+    // Makes the next submit() wait for the semaphore as well, e.g. for uploads or compute work on another queue.
+    // The value is only used for timeline semaphores.
+    void addWaitSemaphore(VkSemaphore semaphore, const VkPipelineStageFlags2 waitStages, const uint64_t value = 0);
+    // Waits for the image acquisition and signals both the render finished semaphore and the timeline.
+    void submit(Queue &queue, VkCommandBuffer commandBuffer, const VkPipelineStageFlags2 waitStage);
+    // Appends the frame batch to the batches already in the submission and flushes all of them with one call.
+    void submit(Queue &queue, SubmissionBuilder &submission, const std::vector<VkCommandBuffer> &commandBuffers,
+        const VkPipelineStageFlags2 waitStage);
+
+    // Runs the callback once the current frame has been completed by the GPU.
+    void retire(std::function<void()> callback);
+    // Returns a binary semaphore from the device pool. It goes back to the pool when the current frame is done.
+    VkSemaphore acquireSemaphore();
+
+    uint32_t getFramesInFlight() const noexcept;
+    // Index of the per-frame resources of the current frame, in range [0, framesInFlight).
+    uint32_t getFrameIndex() const noexcept;
+    // Timeline value which is signaled when the current frame is done.
+    uint64_t getFrameNumber() const noexcept;
+    uint64_t getCompletedFrameNumber() noexcept;
+    bool isFrameComplete(const uint64_t frameNumber) noexcept;
+    bool waitForFrame(const uint64_t frameNumber, const uint64_t timeout = std::numeric_limits<uint64_t>::max()) noexcept;
+    // Waits until every submitted frame is done.
+    void waitIdle() noexcept;
+
+    VkSemaphore getTimeline() noexcept;
+    VkSemaphore getImageAvailableSemaphore() noexcept;
+    VkSemaphore getRenderFinishedSemaphore() noexcept;
+
+private:
+    void collectRetired(const uint64_t completedFrameNumber);
+
+    LogicalDevice &_device;
+    SemaphorePtr _timeline;
+    VkSemaphore _imageAvailableSemaphore = VK_NULL_HANDLE;
+    // Presentation isn't tracked by the timeline, so these stay with their slot instead of going back to the pool.
+    std::vector<SemaphorePtr> _renderFinishedSemaphores;
+    std::deque<std::pair<uint64_t, std::function<void()>>> _retired;
+    std::vector<VkSemaphore> _waitSemaphores;
+    std::vector<VkPipelineStageFlags2> _waitStages;
+    std::vector<uint64_t> _waitValues;
+    uint64_t _frameNumber = 0;
+    uint64_t _submittedFrameNumber = 0;
+    uint32_t _framesInFlight = 0;
+};
+
+} // namespace avocado::vulkan.
+
+#endif
@@ -7,13 +7,40 @@ using namespace std::string_literals;
 
 namespace avocado::vulkan {
 
+namespace {
+
+constexpr VkGraphicsPipelineLibraryFlagBitsEXT pipelineLibraryParts[] = {
+    VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT,
+    VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT,
+    VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT,
+    VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT
+};
+
+// Pipelines with dynamic topology are compatible with all topologies of the class.
+uint32_t getTopologyClass(const VkPrimitiveTopology topology) noexcept {
+    switch (topology) {
+    case VK_PRIMITIVE_TOPOLOGY_POINT_LIST:
+        return 0;
+    case VK_PRIMITIVE_TOPOLOGY_LINE_LIST:
+    case VK_PRIMITIVE_TOPOLOGY_LINE_STRIP:
+    case VK_PRIMITIVE_TOPOLOGY_LINE_LIST_WITH_ADJACENCY:
+    case VK_PRIMITIVE_TOPOLOGY_LINE_STRIP_WITH_ADJACENCY:
+        return 1;
+    case VK_PRIMITIVE_TOPOLOGY_PATCH_LIST:
+        return 3;
+    default:
+        return 2;
+    }
+}
+
+} // namespace.
+
 GraphicsPipelineBuilder::GraphicsPipelineBuilder(LogicalDevice &device):
-    _logicalDevice(device),
-    _pipelineLayout(device.createObjectPointer<VkPipelineLayout>(VK_NULL_HANDLE)) {
+    _logicalDevice(device) {
 }
 
 VkPipelineLayout GraphicsPipelineBuilder::getPipelineLayout() noexcept {
-    return _pipelineLayout.get();
+    return _pipelineLayout;
 }
 
 void GraphicsPipelineBuilder::setColorBlendState(std::unique_ptr<ColorBlendState> state) noexcept {
@@ -44,43 +71,104 @@ void GraphicsPipelineBuilder::setViewportState(std::unique_ptr<ViewportState> vi
     _viewportState = std::move(viewportState);
 }
 
-void GraphicsPipelineBuilder::addFragmentShaderModules(const std::vector<std::vector<char>> &shaderModules) {
-    for (std::vector<char> shaderModule: shaderModules)
-        _shaderModuleCIs.emplace_back(addShaderModule(shaderModule, VK_SHADER_STAGE_FRAGMENT_BIT));
+void GraphicsPipelineBuilder::addFragmentShaderModules(const std::vector<SpirvView> &shaderModules) {
+    for (const SpirvView &shaderModule : shaderModules)
+        addShaderModule(shaderModule, VK_SHADER_STAGE_FRAGMENT_BIT);
 }
 
-void GraphicsPipelineBuilder::addVertexShaderModules(const std::vector<std::vector<char>> &shaderModules) {
-    for (std::vector<char> shaderModule: shaderModules)
-        _shaderModuleCIs.emplace_back(addShaderModule(shaderModule, VK_SHADER_STAGE_VERTEX_BIT));
+void GraphicsPipelineBuilder::addVertexShaderModules(const std::vector<SpirvView> &shaderModules) {
+    for (const SpirvView &shaderModule : shaderModules)
+        addShaderModule(shaderModule, VK_SHADER_STAGE_VERTEX_BIT);
 }
 
-VkPipelineShaderStageCreateInfo GraphicsPipelineBuilder::addShaderModule(const std::vector<char> &data, const VkShaderStageFlagBits shType) {
-    VkPipelineShaderStageCreateInfo shaderStageCreateInfo{}; FILL_S_TYPE(shaderStageCreateInfo);
-
-    VkShaderModuleCreateInfo shaderModuleCreateInfo{}; FILL_S_TYPE(shaderModuleCreateInfo);
-    shaderModuleCreateInfo.codeSize = data.size();
-    shaderModuleCreateInfo.pCode = reinterpret_cast<const uint32_t*>(data.data());
+void GraphicsPipelineBuilder::addShaderModule(const SpirvView code, const VkShaderStageFlagBits shType) {
+    ShaderModuleCache &shaderModuleCache = _logicalDevice.getShaderModuleCache();
+    const uint64_t hash = shaderModuleCache.addCode(code);
+    setHasError(shaderModuleCache.hasError());
+    if (hasError()) {
+        setErrorMessage("Can't add shader module: "s + shaderModuleCache.getErrorMessage());
+        return;
+    }
 
-    VkShaderModule shaderModule = VK_NULL_HANDLE;
-    const VkResult result = vkCreateShaderModule(_logicalDevice.getHandle(), &shaderModuleCreateInfo, nullptr, &shaderModule);
+    addShaderStage(hash, shType);
+}
 
-    setHasError(result != VK_SUCCESS);
+void GraphicsPipelineBuilder::addShaderModuleFile(const std::string &filePath, const VkShaderStageFlagBits shType) {
+    ShaderModuleCache &shaderModuleCache = _logicalDevice.getShaderModuleCache();
+    const uint64_t hash = shaderModuleCache.addFile(filePath);
+    setHasError(shaderModuleCache.hasError());
     if (hasError()) {
-        setErrorMessage("vkCreateShaderModule returned "s + getVkResultString(result));
-        return shaderStageCreateInfo;
+        setErrorMessage("Can't add shader module: "s + shaderModuleCache.getErrorMessage());
+        return;
     }
 
-    _shaderModules.emplace_back(makeObjectPtr(_logicalDevice, shaderModule));
+    addShaderStage(hash, shType);
+}
 
+void GraphicsPipelineBuilder::addShaderStage(const uint64_t shaderModuleHash, const VkShaderStageFlagBits shType) {
+    // The module is taken from the cache when the pipeline is built.
+    VkPipelineShaderStageCreateInfo shaderStageCreateInfo{}; FILL_S_TYPE(shaderStageCreateInfo);
     shaderStageCreateInfo.stage = shType;
-    shaderStageCreateInfo.module = _shaderModules.back().get();
     shaderStageCreateInfo.pName = "main"; // Entry point.
-    return shaderStageCreateInfo;
+    _shaderModuleCIs.push_back(shaderStageCreateInfo);
+    _shaderModuleHashes.push_back(shaderModuleHash);
 }
 
-PipelinePtr GraphicsPipelineBuilder::buildPipeline(VkRenderPass renderPass) {
+bool GraphicsPipelineBuilder::resolveShaderModules() {
+    ShaderModuleCache &shaderModuleCache = _logicalDevice.getShaderModuleCache();
+    for (size_t i = 0; i < _shaderModuleCIs.size(); ++i) {
+        const VkResult result = shaderModuleCache.getShaderModule(_shaderModuleHashes[i], _shaderModuleCIs[i].module);
+        setHasError(result != VK_SUCCESS);
+        if (hasError()) {
+            setErrorMessage("vkCreateShaderModule returned "s + getVkResultString(result));
+            return false;
+        }
+    }
+
+    return true;
+}
+
+VkResult GraphicsPipelineBuilder::createPipelineFromIdentifiers(const VkGraphicsPipelineCreateInfo &pipelineCI,
+    VkPipelineCache pipelineCache, VkPipeline &pipeline) {
+    // Libraries are shared, so they are always created from modules.
+    ShaderModuleCache &shaderModuleCache = _logicalDevice.getShaderModuleCache();
+    if (!shaderModuleCache.areModuleIdentifiersEnabled() || _logicalDevice.isGraphicsPipelineLibraryEnabled() || _shaderModuleCIs.empty())
+        return VK_PIPELINE_COMPILE_REQUIRED;
+
+    std::vector<VkPipelineShaderStageModuleIdentifierCreateInfoEXT> identifierCIs(_shaderModuleCIs.size());
+    std::vector<VkPipelineShaderStageCreateInfo> shaderStageCIs(_shaderModuleCIs);
+    for (size_t i = 0; i < shaderStageCIs.size(); ++i) {
+        const VkShaderModuleIdentifierEXT *identifier = shaderModuleCache.getModuleIdentifier(_shaderModuleHashes[i]);
+        if (identifier == nullptr)
+            return VK_PIPELINE_COMPILE_REQUIRED;
+
+        VkPipelineShaderStageModuleIdentifierCreateInfoEXT identifierCI{}; FILL_S_TYPE(identifierCI);
+        identifierCI.pNext = shaderStageCIs[i].pNext;
+        identifierCI.identifierSize = identifier->identifierSize;
+        identifierCI.pIdentifier = identifier->identifier;
+        identifierCIs[i] = identifierCI;
+
+        shaderStageCIs[i].pNext = &identifierCIs[i];
+        shaderStageCIs[i].module = VK_NULL_HANDLE;
+    }
+
+    // Fails with VK_PIPELINE_COMPILE_REQUIRED unless the pipeline is in the pipeline cache.
+    // The cache only hands out identifiers if pipelineCreationCacheControl is enabled.
+    VkGraphicsPipelineCreateInfo identifierPipelineCI = pipelineCI;
+    identifierPipelineCI.flags |= VK_PIPELINE_CREATE_FAIL_ON_PIPELINE_COMPILE_REQUIRED_BIT;
+    identifierPipelineCI.pStages = shaderStageCIs.data();
+    return vkCreateGraphicsPipelines(_logicalDevice.getHandle(), pipelineCache, 1, &identifierPipelineCI, nullptr, &pipeline);
+}
+
+PipelinePtr GraphicsPipelineBuilder::buildPipeline(VkRenderPass renderPass, VkPipelineCache pipelineCache) {
     VkGraphicsPipelineCreateInfo pipelineCI{}; FILL_S_TYPE(pipelineCI);
 
+    for (VkPipelineShaderStageCreateInfo &shaderStageCI : _shaderModuleCIs) {
+        const auto constantsIt = _specializationConstants.find(shaderStageCI.stage);
+        if (constantsIt != _specializationConstants.end())
+            shaderStageCI.pSpecializationInfo = constantsIt->second.createSpecializationInfo();
+    }
+
     pipelineCI.stageCount = static_cast<uint32_t>(_shaderModuleCIs.size());
     pipelineCI.pStages = _shaderModuleCIs.data();
 
@@ -133,33 +221,38 @@ PipelinePtr GraphicsPipelineBuilder::buildPipeline(VkRenderPass renderPass) {
         pipelineCI.pColorBlendState = &colorBlendStateCI;
     }
 
-    auto pipelineDestroyer = std::bind(vkDestroyPipeline, _logicalDevice.getHandle(), std::placeholders::_1, nullptr);
-
-    VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo{}; FILL_S_TYPE(pipelineLayoutCreateInfo);
-
-    pipelineLayoutCreateInfo.setLayoutCount = _descriptorSetLayouts.size();
-    pipelineLayoutCreateInfo.pSetLayouts = _descriptorSetLayouts.data();
-
-    VkPipelineLayout pipelineLayout;
-    const VkResult pipelineCreationResult = vkCreatePipelineLayout(_logicalDevice.getHandle(), &pipelineLayoutCreateInfo, nullptr, &pipelineLayout);
-    setHasError(pipelineCreationResult != VK_SUCCESS);
-    if (hasError()) {
-        setErrorMessage("vkCreatePipelineLayout returned "s + getVkResultString(pipelineCreationResult));
+    if (_pipelineLayout == VK_NULL_HANDLE && preparePipelineLayout() == VK_NULL_HANDLE)
         return makeObjectPtr<VkPipeline>(_logicalDevice, VK_NULL_HANDLE);
-    }
-
-    _pipelineLayout.reset(pipelineLayout);
 
-    pipelineCI.layout = _pipelineLayout.get();
+    pipelineCI.layout = _pipelineLayout;
     pipelineCI.renderPass = renderPass;
 
     // Create the pipeline.
+    PipelineCache &devicePipelineCache = _logicalDevice.getPipelineCache();
+    if (pipelineCache == VK_NULL_HANDLE)
+        pipelineCache = devicePipelineCache.getHandle();
+
+    // Libraries are compiled once and shared by pipelines, so linking one is much cheaper than
+    // a monolithic compile. buildOptimizedPipeline() can replace it later.
     VkPipeline pipeline = VK_NULL_HANDLE;
-    const VkResult result = vkCreateGraphicsPipelines(_logicalDevice.getHandle(), VK_NULL_HANDLE, 1, &pipelineCI, nullptr, &pipeline);
+    VkResult result = createPipelineFromIdentifiers(pipelineCI, pipelineCache, pipeline);
+    if (result == VK_PIPELINE_COMPILE_REQUIRED) {
+        if (!resolveShaderModules())
+            return makeObjectPtr<VkPipeline>(_logicalDevice, VK_NULL_HANDLE);
+
+        result = (_logicalDevice.isGraphicsPipelineLibraryEnabled() ?
+            createFastLinkedPipeline(pipelineCI, renderPass, pipelineCache, pipeline) :
+            vkCreateGraphicsPipelines(_logicalDevice.getHandle(), pipelineCache, 1, &pipelineCI, nullptr, &pipeline));
+    }
+    // Pipelines built into a thread cache are counted when the cache is merged.
+    if (result == VK_SUCCESS && pipelineCache == devicePipelineCache.getHandle())
+        devicePipelineCache.notifyPipelineCreated();
 
     // Free unneeded resources.
     _shaderModuleCIs.clear();
     _shaderModuleCIs.shrink_to_fit();
+    _shaderModuleHashes.clear();
+    _specializationConstants.clear();
     _colorBlendState = nullptr;
     _dynamicState = nullptr;
     _vertexInputState = nullptr;
@@ -177,10 +270,256 @@ PipelinePtr GraphicsPipelineBuilder::buildPipeline(VkRenderPass renderPass) {
     return makeObjectPtr(_logicalDevice, pipeline);
 }
 
+VkPipelineLayout GraphicsPipelineBuilder::preparePipelineLayout() {
+    if (_pipelineLayout != VK_NULL_HANDLE)
+        return _pipelineLayout;
+
+    PipelineRegistry &pipelineRegistry = _logicalDevice.getPipelineRegistry();
+    _pipelineLayout = pipelineRegistry.getPipelineLayout(_descriptorSetLayouts, _pushConstantRanges);
+    setHasError(pipelineRegistry.hasError());
+    if (hasError())
+        setErrorMessage("Can't get pipeline layout: "s + pipelineRegistry.getErrorMessage());
+
+    return _pipelineLayout;
+}
+
 void GraphicsPipelineBuilder::setDescriptorSetLayouts(std::vector<VkDescriptorSetLayout> &layouts)
 {
     _descriptorSetLayouts = layouts;
 }
 
+void GraphicsPipelineBuilder::addPushConstantRange(const VkShaderStageFlags stageFlags, const uint32_t offset, const uint32_t size) {
+    setHasError(size == 0 || offset % 4 != 0 || size % 4 != 0);
+    if (hasError()) {
+        setErrorMessage("Push constant range offset and size must be multiples of 4");
+        return;
+    }
+
+    const uint32_t maxPushConstantsSize = _logicalDevice.getLimits().maxPushConstantsSize;
+    setHasError(offset >= maxPushConstantsSize || size > maxPushConstantsSize - offset);
+    if (hasError()) {
+        setErrorMessage("Push constant range exceeds maxPushConstantsSize "s + std::to_string(maxPushConstantsSize));
+        return;
+    }
+
+    _pushConstantRanges.push_back({stageFlags, offset, size});
+}
+
+std::string GraphicsPipelineBuilder::createStateKey(VkRenderPass renderPass) {
+    std::string key;
+    for (const VkGraphicsPipelineLibraryFlagBitsEXT libraryPart : pipelineLibraryParts)
+        appendLibraryStateKey(key, libraryPart);
+
+    appendSharedStateKey(key, renderPass);
+    return key;
+}
+
+bool GraphicsPipelineBuilder::isFastLinked() const noexcept {
+    return !_pipelineLibraries.empty();
+}
+
+PipelinePtr GraphicsPipelineBuilder::buildOptimizedPipeline(VkPipelineCache pipelineCache) {
+    assert(isFastLinked());
+
+    PipelineCache &devicePipelineCache = _logicalDevice.getPipelineCache();
+    if (pipelineCache == VK_NULL_HANDLE)
+        pipelineCache = devicePipelineCache.getHandle();
+
+    VkPipeline pipeline = VK_NULL_HANDLE;
+    const VkResult result = linkPipelineLibraries(VK_PIPELINE_CREATE_LINK_TIME_OPTIMIZATION_BIT_EXT, pipelineCache, pipeline);
+    if (result == VK_SUCCESS && pipelineCache == devicePipelineCache.getHandle())
+        devicePipelineCache.notifyPipelineCreated();
+
+    setHasError(result != VK_SUCCESS);
+    if (hasError()) {
+        setErrorMessage("vkCreateGraphicsPipelines returned "s + getVkResultString(result));
+        return makeObjectPtr<VkPipeline>(_logicalDevice, VK_NULL_HANDLE);
+    }
+
+    return makeObjectPtr(_logicalDevice, pipeline);
+}
+
+void GraphicsPipelineBuilder::appendLibraryStateKey(std::string &key, const VkGraphicsPipelineLibraryFlagBitsEXT libraryPart) {
+    utils::appendKeyBytes(key, libraryPart);
+    for (size_t i = 0; i < _shaderModuleCIs.size(); ++i) {
+        if (!isStageInLibrary(_shaderModuleCIs[i].stage, libraryPart))
+            continue;
+
+        utils::appendKeyBytes(key, _shaderModuleCIs[i].stage);
+        utils::appendKeyBytes(key, _shaderModuleHashes[i]);
+
+        const auto constantsIt = _specializationConstants.find(_shaderModuleCIs[i].stage);
+        if (constantsIt != _specializationConstants.end())
+            constantsIt->second.appendKey(key);
+        else
+            utils::appendKeyBytes(key, size_t{0});
+    }
+
+    // States which are not set are marked, so they differ from default constructed ones.
+    switch (libraryPart) {
+    case VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT:
+        utils::appendKeyBytes(key, _vertexInputState != nullptr);
+        if (_vertexInputState != nullptr) {
+            utils::appendKeyBytes(key, _vertexInputState->getBindingDescriptionData(), _vertexInputState->getBindingDescriptionsCount());
+            utils::appendKeyBytes(key, _vertexInputState->getAttributeDescriptionData(), _vertexInputState->getAttributeDescriptionsCount());
+        }
+
+        // A dynamic topology has to be of the same class as the baked one.
+        utils::appendKeyBytes(key, _inputAsmState != nullptr);
+        if (_inputAsmState != nullptr) {
+            utils::appendKeyBytes(key, isDynamic(VK_DYNAMIC_STATE_PRIMITIVE_TOPOLOGY) ?
+                getTopologyClass(_inputAsmState->getTopology()) : static_cast<uint32_t>(_inputAsmState->getTopology()));
+        }
+        break;
+    case VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT:
+        // Dynamic states are not part of the key, the driver ignores their baked values.
+        utils::appendKeyBytes(key, _viewportState != nullptr);
+        if (_viewportState != nullptr) {
+            if (isDynamic(VK_DYNAMIC_STATE_VIEWPORT))
+                utils::appendKeyBytes(key, _viewportState->getViewportCount());
+            else
+                utils::appendKeyBytes(key, _viewportState->getViewports(), _viewportState->getViewportCount());
+
+            if (isDynamic(VK_DYNAMIC_STATE_SCISSOR))
+                utils::appendKeyBytes(key, _viewportState->getScissorCount());
+            else
+                utils::appendKeyBytes(key, _viewportState->getScissors(), _viewportState->getScissorCount());
+        }
+
+        utils::appendKeyBytes(key, _rasterizationState != nullptr);
+        if (_rasterizationState != nullptr) {
+            utils::appendKeyBytes(key, _rasterizationState->isDepthClampEnabled());
+            if (!isDynamic(VK_DYNAMIC_STATE_RASTERIZER_DISCARD_ENABLE))
+                utils::appendKeyBytes(key, _rasterizationState->isRasterizerDiscardEnabled());
+            if (!isDynamic(VK_DYNAMIC_STATE_DEPTH_BIAS_ENABLE))
+                utils::appendKeyBytes(key, _rasterizationState->isDepthBiasEnabled());
+            if (!isDynamic(VK_DYNAMIC_STATE_LINE_WIDTH))
+                utils::appendKeyBytes(key, _rasterizationState->getLineWidth());
+            if (!isDynamic(VK_DYNAMIC_STATE_POLYGON_MODE_EXT))
+                utils::appendKeyBytes(key, _rasterizationState->getPolygonMode());
+            if (!isDynamic(VK_DYNAMIC_STATE_CULL_MODE))
+                utils::appendKeyBytes(key, _rasterizationState->getCullMode());
+            if (!isDynamic(VK_DYNAMIC_STATE_FRONT_FACE))
+                utils::appendKeyBytes(key, _rasterizationState->getFrontFace());
+        }
+        break;
+    case VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT:
+    case VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT:
+        utils::appendKeyBytes(key, _multisampleState != nullptr);
+        if (_multisampleState != nullptr) {
+            utils::appendKeyBytes(key, _multisampleState->getRasterizationSamples());
+            utils::appendKeyBytes(key, _multisampleState->getMinSampleShading());
+        }
+
+        if (libraryPart == VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT)
+            break;
+
+        utils::appendKeyBytes(key, _colorBlendState != nullptr);
+        if (_colorBlendState != nullptr) {
+            utils::appendKeyBytes(key, _colorBlendState->isLogicOpEnabled());
+            utils::appendKeyBytes(key, _colorBlendState->getLogicOp());
+            if (isDynamic(VK_DYNAMIC_STATE_COLOR_BLEND_ENABLE_EXT)) {
+                std::vector<VkPipelineColorBlendAttachmentState> attachments(_colorBlendState->getAttachments(),
+                    _colorBlendState->getAttachments() + _colorBlendState->getAttachmentCount());
+                for (VkPipelineColorBlendAttachmentState &attachment : attachments)
+                    attachment.blendEnable = VK_FALSE;
+
+                utils::appendKeyBytes(key, attachments);
+            } else {
+                utils::appendKeyBytes(key, _colorBlendState->getAttachments(), _colorBlendState->getAttachmentCount());
+            }
+        }
+        break;
+    default:
+        assert(false);
+        break;
+    }
+}
+
+void GraphicsPipelineBuilder::appendSharedStateKey(std::string &key, VkRenderPass renderPass) {
+    utils::appendKeyBytes(key, _dynamicState != nullptr);
+    if (_dynamicState != nullptr)
+        utils::appendKeyBytes(key, _dynamicState->getDynamicStates(), _dynamicState->getDynamicStateCount());
+
+    utils::appendKeyBytes(key, _descriptorSetLayouts);
+    utils::appendKeyBytes(key, _pushConstantRanges);
+    utils::appendKeyBytes(key, renderPass);
+}
+
+bool GraphicsPipelineBuilder::isDynamic(const VkDynamicState state) const noexcept {
+    return (_dynamicState != nullptr && _dynamicState->isDynamic(state));
+}
+
+bool GraphicsPipelineBuilder::isStageInLibrary(const VkShaderStageFlagBits stage, const VkGraphicsPipelineLibraryFlagBitsEXT libraryPart) noexcept {
+    switch (libraryPart) {
+    case VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT:
+        return (stage != VK_SHADER_STAGE_FRAGMENT_BIT);
+    case VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT:
+        return (stage == VK_SHADER_STAGE_FRAGMENT_BIT);
+    default:
+        return false;
+    }
+}
+
+VkResult GraphicsPipelineBuilder::createFastLinkedPipeline(const VkGraphicsPipelineCreateInfo &pipelineCI,
+    VkRenderPass renderPass, VkPipelineCache pipelineCache, VkPipeline &pipeline) {
+    PipelineRegistry &pipelineRegistry = _logicalDevice.getPipelineRegistry();
+    _pipelineLibraries.clear();
+    for (const VkGraphicsPipelineLibraryFlagBitsEXT libraryPart : pipelineLibraryParts) {
+        std::string key;
+        appendLibraryStateKey(key, libraryPart);
+        appendSharedStateKey(key, renderPass);
+
+        VkPipeline library = pipelineRegistry.findPipelineLibrary(key);
+        if (library == VK_NULL_HANDLE) {
+            const VkResult result = createPipelineLibrary(pipelineCI, libraryPart, pipelineCache, library);
+            if (result != VK_SUCCESS) {
+                _pipelineLibraries.clear();
+                return result;
+            }
+
+            library = pipelineRegistry.addPipelineLibrary(std::move(key), library);
+        }
+
+        _pipelineLibraries.push_back(library);
+    }
+
+    return linkPipelineLibraries(0, pipelineCache, pipeline);
+}
+
+VkResult GraphicsPipelineBuilder::createPipelineLibrary(const VkGraphicsPipelineCreateInfo &pipelineCI,
+    const VkGraphicsPipelineLibraryFlagBitsEXT libraryPart, VkPipelineCache pipelineCache, VkPipeline &library) {
+    std::vector<VkPipelineShaderStageCreateInfo> shaderStageCIs;
+    for (const VkPipelineShaderStageCreateInfo &shaderStageCI : _shaderModuleCIs) {
+        if (isStageInLibrary(shaderStageCI.stage, libraryPart))
+            shaderStageCIs.push_back(shaderStageCI);
+    }
+
+    VkGraphicsPipelineLibraryCreateInfoEXT libraryCI{}; FILL_S_TYPE(libraryCI);
+    libraryCI.flags = libraryPart;
+
+    // States of the other parts are ignored by the driver.
+    VkGraphicsPipelineCreateInfo libraryPipelineCI = pipelineCI;
+    libraryPipelineCI.pNext = &libraryCI;
+    libraryPipelineCI.flags |= VK_PIPELINE_CREATE_LIBRARY_BIT_KHR | VK_PIPELINE_CREATE_RETAIN_LINK_TIME_OPTIMIZATION_INFO_BIT_EXT;
+    libraryPipelineCI.stageCount = static_cast<uint32_t>(shaderStageCIs.size());
+    libraryPipelineCI.pStages = shaderStageCIs.data();
+
+    return vkCreateGraphicsPipelines(_logicalDevice.getHandle(), pipelineCache, 1, &libraryPipelineCI, nullptr, &library);
+}
+
+VkResult GraphicsPipelineBuilder::linkPipelineLibraries(const VkPipelineCreateFlags flags, VkPipelineCache pipelineCache, VkPipeline &pipeline) {
+    VkPipelineLibraryCreateInfoKHR libraryCI{}; FILL_S_TYPE(libraryCI);
+    libraryCI.libraryCount = static_cast<uint32_t>(_pipelineLibraries.size());
+    libraryCI.pLibraries = _pipelineLibraries.data();
+
+    VkGraphicsPipelineCreateInfo pipelineCI{}; FILL_S_TYPE(pipelineCI);
+    pipelineCI.pNext = &libraryCI;
+    pipelineCI.flags = flags;
+    pipelineCI.layout = _pipelineLayout;
+
+    return vkCreateGraphicsPipelines(_logicalDevice.getHandle(), pipelineCache, 1, &pipelineCI, nullptr, &pipeline);
+}
+
 } // namespace avocado::vulkan.
 
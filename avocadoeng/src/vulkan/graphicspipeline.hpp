@@ -5,6 +5,7 @@
 
 #include "logicaldevice.hpp"
 #include "pointertypes.hpp"
+#include "specializationconstants.hpp"
 #include "vulkan_core.h"
 #include "states/colorblendstate.hpp"
 #include "states/dynamicstate.hpp"
@@ -17,7 +18,9 @@
 #include <vulkan/vulkan.h>
 
 #include <functional>
+#include <map>
 #include <memory>
+#include <string>
 #include <vector>
 
 namespace avocado::vulkan {
@@ -42,9 +45,25 @@ public:
     void setRasterizationState(std::unique_ptr<RasterizationState> rasterizationState) noexcept;
     void setVertexInputState(std::unique_ptr<VertexInputState> vertexInState) noexcept;
     void setViewportState(std::unique_ptr<ViewportState> viewportState) noexcept;
-    void addFragmentShaderModules(const std::vector<std::vector<char>> &shaderModules);
-    void addVertexShaderModules(const std::vector<std::vector<char>> &shaderModules);
+    // Modules come from the shader module cache of the device, equal code is one module.
+    void addFragmentShaderModules(const std::vector<SpirvView> &shaderModules);
+    void addVertexShaderModules(const std::vector<SpirvView> &shaderModules);
+    // The file is read only the first time any builder adds it.
+    void addShaderModuleFile(const std::string &filePath, const VkShaderStageFlagBits shType);
     void setDescriptorSetLayouts(std::vector<VkDescriptorSetLayout> &layouts);
+    // Offset and size are multiples of 4. Vulkan guarantees 128 bytes of push constants.
+    void addPushConstantRange(const VkShaderStageFlags stageFlags, const uint32_t offset, const uint32_t size);
+    // Applies to all modules of the stage. Constants are part of the state key, so each set of values
+    // is its own pipeline.
+    template <typename T>
+    void setSpecializationConstant(const VkShaderStageFlagBits stage, const uint32_t constantId, const T value) {
+        _specializationConstants[stage].set(constantId, value);
+    }
+    // Everything the pipeline is created from. Shaders are represented by hashes of their code.
+    std::string createStateKey(VkRenderPass renderPass);
+    // Gets the layout from the pipeline registry. buildPipeline() does it if it wasn't done before,
+    // asynchronous compilation does it on the requesting thread.
+    VkPipelineLayout preparePipelineLayout();
 
 private:
     template <typename T>
@@ -53,12 +72,28 @@ private:
         return state.createCreateInfo();
     }
 
-    VkPipelineShaderStageCreateInfo addShaderModule(const std::vector<char> &data, const VkShaderStageFlagBits shType);
+    void addShaderModule(const SpirvView code, const VkShaderStageFlagBits shType);
+    void addShaderStage(const uint64_t shaderModuleHash, const VkShaderStageFlagBits shType);
+    bool resolveShaderModules();
+    // Returns VK_PIPELINE_COMPILE_REQUIRED if the modules have to be created.
+    VkResult createPipelineFromIdentifiers(const VkGraphicsPipelineCreateInfo &pipelineCI, VkPipelineCache pipelineCache, VkPipeline &pipeline);
+    // Each library part has its own key, so libraries are shared by pipelines which differ in other parts.
+    void appendLibraryStateKey(std::string &key, const VkGraphicsPipelineLibraryFlagBitsEXT libraryPart);
+    void appendSharedStateKey(std::string &key, VkRenderPass renderPass);
+    bool isDynamic(const VkDynamicState state) const noexcept;
+    static bool isStageInLibrary(const VkShaderStageFlagBits stage, const VkGraphicsPipelineLibraryFlagBitsEXT libraryPart) noexcept;
+    VkResult createFastLinkedPipeline(const VkGraphicsPipelineCreateInfo &pipelineCI, VkRenderPass renderPass,
+        VkPipelineCache pipelineCache, VkPipeline &pipeline);
+    VkResult createPipelineLibrary(const VkGraphicsPipelineCreateInfo &pipelineCI, const VkGraphicsPipelineLibraryFlagBitsEXT libraryPart,
+        VkPipelineCache pipelineCache, VkPipeline &library);
+    VkResult linkPipelineLibraries(const VkPipelineCreateFlags flags, VkPipelineCache pipelineCache, VkPipeline &pipeline);
 
     LogicalDevice &_logicalDevice;
-    std::vector<ShaderModulePtr> _shaderModules;
+    // Keys of the modules in the shader module cache.
+    std::vector<uint64_t> _shaderModuleHashes;
 
     std::vector<VkPipelineShaderStageCreateInfo> _shaderModuleCIs;
+    std::map<VkShaderStageFlagBits, SpecializationConstants> _specializationConstants;
     std::unique_ptr<ColorBlendState> _colorBlendState = nullptr;
     std::unique_ptr<DynamicState> _dynamicState = nullptr;
     std::unique_ptr<VertexInputState> _vertexInputState = nullptr;
@@ -66,11 +101,20 @@ private:
     std::unique_ptr<MultisampleState> _multisampleState = nullptr;
     std::unique_ptr<RasterizationState> _rasterizationState = nullptr;
     std::unique_ptr<ViewportState> _viewportState = nullptr;
-    avocado::vulkan::ObjectPtr<VkPipelineLayout> _pipelineLayout;
+    // Owned by the pipeline registry.
+    VkPipelineLayout _pipelineLayout = VK_NULL_HANDLE;
     std::vector<VkDescriptorSetLayout> _descriptorSetLayouts;
+    std::vector<VkPushConstantRange> _pushConstantRanges;
+    // Owned by the pipeline registry, set if the last pipeline was fast-linked.
+    std::vector<VkPipeline> _pipelineLibraries;
 
 public:
-    PipelinePtr buildPipeline(VkRenderPass renderPass);
+    // The device pipeline cache is used if no cache is given.
+    PipelinePtr buildPipeline(VkRenderPass renderPass, VkPipelineCache pipelineCache = VK_NULL_HANDLE);
+    // True if the device supports pipeline libraries and buildPipeline() linked the pipeline from them.
+    bool isFastLinked() const noexcept;
+    // Links the same libraries with link time optimization. Slow, meant for background threads.
+    PipelinePtr buildOptimizedPipeline(VkPipelineCache pipelineCache = VK_NULL_HANDLE);
     void destroyPipeline();
 };
 
@@ -19,22 +19,17 @@ Image::Image(LogicalDevice &device, const uint32_t width, const uint32_t height,
     _createInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
 }
 
-void Image::allocateMemory(PhysicalDevice &physDevice, const VkMemoryPropertyFlags memoryFlags) {
-    // todo Same code with Buffer class. Extract somewhere.
+void Image::allocateMemory(PhysicalDevice &physDevice, const MemoryUsage usage) {
     VkMemoryRequirements memRequirements{};
     vkGetImageMemoryRequirements(_device.getHandle(), _handle.get(), &memRequirements);
 
-    const uint32_t foundType = physDevice.findMemoryTypeIndex(memoryFlags, memRequirements.memoryTypeBits);
-
-    VkMemoryAllocateInfo imageMemAI{}; FILL_S_TYPE(imageMemAI);
-    imageMemAI.allocationSize = memRequirements.size;
-    imageMemAI.memoryTypeIndex = foundType;
-
-    VkDeviceMemory deviceMemory;
-    const VkResult allocationResult = vkAllocateMemory(_device.getHandle(), &imageMemAI, nullptr, &deviceMemory);
+    VkDeviceMemory deviceMemory = VK_NULL_HANDLE;
+    const VkResult allocationResult = physDevice.allocateMemory(_device.getHandle(), memRequirements, usage, deviceMemory);
     setHasError(allocationResult != VK_SUCCESS);
     if (!hasError())
         _textureImageMemory.reset(deviceMemory);
+    else if (allocationResult == VK_ERROR_FEATURE_NOT_PRESENT)
+        setErrorMessage("No memory type qualifies for the image");
     else
         setErrorMessage("vkAllocateMemory returned "s + getVkResultString(allocationResult));
 }
@@ -65,6 +60,14 @@ VkImage Image::getHandle() noexcept {
     return _handle.get();
 }
 
+uint32_t Image::getMipLevels() const noexcept {
+    return _createInfo.mipLevels;
+}
+
+uint32_t Image::getArrayLayerCount() const noexcept {
+    return _createInfo.arrayLayers;
+}
+
 void Image::setArrayLayerCount(const uint32_t count) {
     _createInfo.arrayLayers = count;
 }
@@ -2,6 +2,7 @@
 #define IMAGE_HPP
 
 #include "pointertypes.hpp"
+#include "types.hpp"
 
 #include "../errorstorage.hpp"
 
@@ -14,10 +15,12 @@ class PhysicalDevice;
 class Image: public core::ErrorStorage {
 public:
     explicit Image(LogicalDevice &device, const uint32_t width, const uint32_t height, const VkImageType imageType);
-    void allocateMemory(PhysicalDevice &physDevice, const VkMemoryPropertyFlags memoryFlags);
+    void allocateMemory(PhysicalDevice &physDevice, const MemoryUsage usage);
     void bindMemory();
     void create();
     VkImage getHandle() noexcept;
+    uint32_t getMipLevels() const noexcept;
+    uint32_t getArrayLayerCount() const noexcept;
     void setArrayLayerCount(const uint32_t count);
     void setDepth(const uint32_t depth);
     void setFormat(const VkFormat format);
@@ -19,7 +19,14 @@ LogicalDevice::LogicalDevice():
 }
 
 LogicalDevice::LogicalDevice(VkDevice dev):
-    _dev(makeFundamentalObjectPtr(dev)) {
+    _dev(makeFundamentalObjectPtr(dev)),
+    _fencePool(std::make_unique<FencePool>(dev)),
+    _semaphorePool(std::make_unique<SemaphorePool>(dev)),
+    _pipelineCache(std::make_unique<PipelineCache>(dev)),
+    _pipelineRegistry(std::make_unique<PipelineRegistry>(dev)),
+    _shaderModuleCache(std::make_unique<ShaderModuleCache>(dev)),
+    _samplerCache(std::make_unique<SamplerCache>(dev)),
+    _descriptorSetCache(std::make_unique<DescriptorSetCache>(dev)) {
 }
 
 VkDevice LogicalDevice::getHandle() noexcept {
@@ -42,10 +49,13 @@ VkDescriptorSetLayoutBinding LogicalDevice::createLayoutBinding(const uint32_t b
     return layoutBinding;
 }
 
-VkDescriptorSetLayout LogicalDevice::createDescriptorSetLayout(const std::vector<VkDescriptorSetLayoutBinding> &bindings) {
+VkDescriptorSetLayout LogicalDevice::createDescriptorSetLayout(const std::vector<VkDescriptorSetLayoutBinding> &bindings,
+    const bool isPushDescriptor) {
     assert(_dev != nullptr);
 
     VkDescriptorSetLayoutCreateInfo createInfo{}; FILL_S_TYPE(createInfo);
+    if (isPushDescriptor && isPushDescriptorEnabled())
+        createInfo.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_PUSH_DESCRIPTOR_BIT_KHR;
     createInfo.bindingCount = static_cast<uint32_t>(bindings.size());
     createInfo.pBindings = bindings.data();
 
@@ -96,11 +106,16 @@ std::pair<VkDescriptorSet, VkWriteDescriptorSet> LogicalDevice::createWriteDescr
 }
 
 VkDescriptorPool LogicalDevice::createDescriptorPool(const size_t descriptorCount) {
-    std::array<VkDescriptorPoolSize, 2> descriptorPoolSizes{};
+    std::array<VkDescriptorPoolSize, 4> descriptorPoolSizes{};
     descriptorPoolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
     descriptorPoolSizes[0].descriptorCount = descriptorCount;
     descriptorPoolSizes[1].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
     descriptorPoolSizes[1].descriptorCount = descriptorCount;
+    // Used by compute shaders.
+    descriptorPoolSizes[2].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    descriptorPoolSizes[2].descriptorCount = descriptorCount;
+    descriptorPoolSizes[3].type = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+    descriptorPoolSizes[3].descriptorCount = descriptorCount;
 
     VkDescriptorPoolCreateInfo dPoolCI{}; FILL_S_TYPE(dPoolCI);
     dPoolCI.poolSizeCount = descriptorPoolSizes.size();
@@ -131,7 +146,13 @@ Queue LogicalDevice::getPresentQueue(const uint32_t index) noexcept {
 
 Queue LogicalDevice::getTransferQueue(const uint32_t index) noexcept {
     VkQueue queue = VK_NULL_HANDLE;
-    vkGetDeviceQueue(_dev.get(), _presentQueueFamily, index, &queue);
+    vkGetDeviceQueue(_dev.get(), _transferQueueFamily, index, &queue);
+    return Queue(queue);
+}
+
+Queue LogicalDevice::getComputeQueue(const uint32_t index) noexcept {
+    VkQueue queue = VK_NULL_HANDLE;
+    vkGetDeviceQueue(_dev.get(), _computeQueueFamily, index, &queue);
     return Queue(queue);
 }
 
@@ -140,15 +161,74 @@ std::unique_ptr<DebugUtils> LogicalDevice::createDebugUtils() {
     return std::unique_ptr<DebugUtils>(debugUtils);
 }
 
-void LogicalDevice::setQueueFamilies(const QueueFamily graphicsQueueFamily, const QueueFamily presentQueueFamily, const QueueFamily transferQueueFamily) noexcept {
+void LogicalDevice::setQueueFamilies(const QueueFamily graphicsQueueFamily, const QueueFamily presentQueueFamily,
+    const QueueFamily transferQueueFamily, const QueueFamily computeQueueFamily) noexcept {
     _graphicsQueueFamily = graphicsQueueFamily;
     _presentQueueFamily = presentQueueFamily;
     _transferQueueFamily = transferQueueFamily;
+    _computeQueueFamily = computeQueueFamily;
+}
+
+void LogicalDevice::setGraphicsPipelineLibraryEnabled(const bool isEnabled) noexcept {
+    _isGraphicsPipelineLibraryEnabled = isEnabled;
+}
+
+bool LogicalDevice::isGraphicsPipelineLibraryEnabled() const noexcept {
+    return _isGraphicsPipelineLibraryEnabled;
+}
+
+void LogicalDevice::setLimits(const VkPhysicalDeviceLimits &limits) noexcept {
+    _limits = limits;
+}
+
+const VkPhysicalDeviceLimits &LogicalDevice::getLimits() const noexcept {
+    return _limits;
+}
+
+void LogicalDevice::setDescriptorIndexingEnabled(const bool isEnabled) noexcept {
+    _isDescriptorIndexingEnabled = isEnabled;
+}
+
+bool LogicalDevice::isDescriptorIndexingEnabled() const noexcept {
+    return _isDescriptorIndexingEnabled;
 }
 
-VkFence LogicalDevice::createFence() noexcept {
+void LogicalDevice::loadExtendedDynamicState3Commands() noexcept {
+    _extendedDynamicState3Commands.setColorBlendEnable = reinterpret_cast<PFN_vkCmdSetColorBlendEnableEXT>(
+        vkGetDeviceProcAddr(_dev.get(), "vkCmdSetColorBlendEnableEXT"));
+    _extendedDynamicState3Commands.setPolygonMode = reinterpret_cast<PFN_vkCmdSetPolygonModeEXT>(
+        vkGetDeviceProcAddr(_dev.get(), "vkCmdSetPolygonModeEXT"));
+}
+
+bool LogicalDevice::isExtendedDynamicState3Enabled() const noexcept {
+    return (_extendedDynamicState3Commands.setColorBlendEnable != nullptr &&
+        _extendedDynamicState3Commands.setPolygonMode != nullptr);
+}
+
+const ExtendedDynamicState3Commands &LogicalDevice::getExtendedDynamicState3Commands() const noexcept {
+    return _extendedDynamicState3Commands;
+}
+
+void LogicalDevice::loadPushDescriptorCommands() noexcept {
+    _pushDescriptorCommands.pushDescriptorSet = reinterpret_cast<PFN_vkCmdPushDescriptorSetKHR>(
+        vkGetDeviceProcAddr(_dev.get(), "vkCmdPushDescriptorSetKHR"));
+    _pushDescriptorCommands.pushDescriptorSetWithTemplate = reinterpret_cast<PFN_vkCmdPushDescriptorSetWithTemplateKHR>(
+        vkGetDeviceProcAddr(_dev.get(), "vkCmdPushDescriptorSetWithTemplateKHR"));
+}
+
+bool LogicalDevice::isPushDescriptorEnabled() const noexcept {
+    return (_pushDescriptorCommands.pushDescriptorSet != nullptr &&
+        _pushDescriptorCommands.pushDescriptorSetWithTemplate != nullptr);
+}
+
+const PushDescriptorCommands &LogicalDevice::getPushDescriptorCommands() const noexcept {
+    return _pushDescriptorCommands;
+}
+
+VkFence LogicalDevice::createFence(const bool signaled) noexcept {
     VkFenceCreateInfo fenceCI{}; FILL_S_TYPE(fenceCI);
-    fenceCI.flags = VK_FENCE_CREATE_SIGNALED_BIT;
+    if (signaled)
+        fenceCI.flags = VK_FENCE_CREATE_SIGNALED_BIT;
 
     VkFence fence;
     const VkResult result = vkCreateFence(_dev.get(), &fenceCI, nullptr, &fence);
@@ -186,35 +266,86 @@ VkSemaphore LogicalDevice::createSemaphore() noexcept {
     return semaphore;
 }
 
-SamplerPtr LogicalDevice::createSampler(PhysicalDevice &physicalDevice) {
-    VkSamplerCreateInfo samplerInfo{};
-    samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
-    samplerInfo.magFilter = VK_FILTER_LINEAR;
-    samplerInfo.minFilter = VK_FILTER_LINEAR;
-    samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER;
-    samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER;
-    samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER;
-    samplerInfo.anisotropyEnable = VK_FALSE;
-
-    VkPhysicalDeviceProperties properties{};
-    vkGetPhysicalDeviceProperties(physicalDevice.getHandle(), &properties);
-    samplerInfo.maxAnisotropy = properties.limits.maxSamplerAnisotropy;
-    samplerInfo.borderColor = VK_BORDER_COLOR_INT_OPAQUE_BLACK;
-    samplerInfo.unnormalizedCoordinates = VK_FALSE;
-    samplerInfo.compareEnable = VK_FALSE;
-    samplerInfo.compareOp = VK_COMPARE_OP_ALWAYS;
-    samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
-    samplerInfo.mipLodBias = 0.0f;
-    samplerInfo.minLod = 0.0f;
-    samplerInfo.maxLod = 0.0f;
-
-    VkSampler textureSampler;
-    const VkResult samplerCreateResult = vkCreateSampler(_dev.get(), &samplerInfo, nullptr, &textureSampler);
-    setHasError(samplerCreateResult != VK_SUCCESS);
+VkSemaphore LogicalDevice::createTimelineSemaphore(const uint64_t initialValue) noexcept {
+    VkSemaphoreTypeCreateInfo semaphoreTypeCI{}; FILL_S_TYPE(semaphoreTypeCI);
+    semaphoreTypeCI.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+    semaphoreTypeCI.initialValue = initialValue;
+
+    VkSemaphore semaphore;
+    VkSemaphoreCreateInfo semaphoreCI{}; FILL_S_TYPE(semaphoreCI);
+    semaphoreCI.pNext = &semaphoreTypeCI;
+    const VkResult result = vkCreateSemaphore(_dev.get(), &semaphoreCI, nullptr, &semaphore);
+    setHasError(result != VK_SUCCESS);
+    if (hasError())
+        setErrorMessage("vkCreateSemaphore returned "s + getVkResultString(result));
+
+    return semaphore;
+}
+
+FencePool &LogicalDevice::getFencePool() noexcept {
+    assert(_fencePool != nullptr);
+
+    return *_fencePool;
+}
+
+SemaphorePool &LogicalDevice::getSemaphorePool() noexcept {
+    assert(_semaphorePool != nullptr);
+
+    return *_semaphorePool;
+}
+
+PipelineCache &LogicalDevice::getPipelineCache() noexcept {
+    assert(_pipelineCache != nullptr);
+
+    return *_pipelineCache;
+}
+
+PipelineRegistry &LogicalDevice::getPipelineRegistry() noexcept {
+    assert(_pipelineRegistry != nullptr);
+
+    return *_pipelineRegistry;
+}
+
+ShaderModuleCache &LogicalDevice::getShaderModuleCache() noexcept {
+    assert(_shaderModuleCache != nullptr);
+
+    return *_shaderModuleCache;
+}
+
+SamplerCache &LogicalDevice::getSamplerCache() noexcept {
+    assert(_samplerCache != nullptr);
+
+    return *_samplerCache;
+}
+
+DescriptorSetCache &LogicalDevice::getDescriptorSetCache() noexcept {
+    assert(_descriptorSetCache != nullptr);
+
+    return *_descriptorSetCache;
+}
+
+uint64_t LogicalDevice::getSemaphoreCounterValue(VkSemaphore semaphore) noexcept {
+    uint64_t value = 0;
+    const VkResult result = vkGetSemaphoreCounterValue(_dev.get(), semaphore, &value);
+    setHasError(result != VK_SUCCESS);
+    if (hasError())
+        setErrorMessage("vkGetSemaphoreCounterValue returned "s + getVkResultString(result));
+
+    return value;
+}
+
+bool LogicalDevice::waitForSemaphore(VkSemaphore semaphore, const uint64_t value, uint64_t timeout) noexcept {
+    VkSemaphoreWaitInfo waitInfo{}; FILL_S_TYPE(waitInfo);
+    waitInfo.semaphoreCount = 1;
+    waitInfo.pSemaphores = &semaphore;
+    waitInfo.pValues = &value;
+
+    const VkResult result = vkWaitSemaphores(_dev.get(), &waitInfo, timeout);
+    setHasError(result != VK_SUCCESS && result != VK_TIMEOUT);
     if (hasError())
-        setErrorMessage("vkCreateSampler returned "s + getVkResultString(samplerCreateResult));
+        setErrorMessage("vkWaitSemaphores returned "s + getVkResultString(result));
 
-    return createObjectPointer(textureSampler);
+    return (result == VK_SUCCESS);
 }
 
 VkCommandPool LogicalDevice::createCommandPool(const VkCommandPoolCreateFlags flags, const QueueFamily queueFamilyIndex) noexcept {
@@ -2,8 +2,15 @@
 #define AVOCADO_VULKAN_LOGICAL_DEVICE
 
 #include "commandbuffer.hpp"
+#include "descriptorsetcache.hpp"
+#include "fencepool.hpp"
+#include "pipelinecache.hpp"
+#include "pipelineregistry.hpp"
 #include "queue.hpp"
 #include "pointertypes.hpp"
+#include "samplercache.hpp"
+#include "semaphorepool.hpp"
+#include "shadermodulecache.hpp"
 #include "types.hpp"
 
 #include "../errorstorage.hpp"
@@ -35,7 +42,10 @@ public:
     VkDescriptorSetLayoutBinding createLayoutBinding(const uint32_t bindingNumber, const VkDescriptorType type,
         const uint32_t descriptorCount, const VkShaderStageFlags flags, const std::vector<VkSampler> &samplers = {}) noexcept;
 
-    VkDescriptorSetLayout createDescriptorSetLayout(const std::vector<VkDescriptorSetLayoutBinding> &bindings);
+    // A push descriptor layout is created only if push descriptors are enabled, check isPushDescriptorEnabled()
+    // to know whether sets of the layout are pushed or allocated.
+    VkDescriptorSetLayout createDescriptorSetLayout(const std::vector<VkDescriptorSetLayoutBinding> &bindings,
+        const bool isPushDescriptor = false);
     void updateDescriptorSet(const std::vector<VkWriteDescriptorSet> &descriptorWriteSets) noexcept;
     VkDescriptorBufferInfo createDescriptorBufferInfo(Buffer &buffer, const size_t bufferSize) noexcept;
     std::pair<VkDescriptorSet, VkWriteDescriptorSet> createWriteDescriptorSet(
@@ -45,17 +55,49 @@ public:
     Queue getGraphicsQueue(const uint32_t index) noexcept;
     Queue getPresentQueue(const uint32_t index) noexcept;
     Queue getTransferQueue(const uint32_t index) noexcept;
+    Queue getComputeQueue(const uint32_t index) noexcept;
 
     std::unique_ptr<DebugUtils> createDebugUtils();
 
     // todo this is supposed to be used by PhysicalDevice, not straightly.
-    void setQueueFamilies(const QueueFamily graphicsQF, const QueueFamily presentQF, const QueueFamily transferQF) noexcept;
-    VkFence createFence() noexcept;
+    void setQueueFamilies(const QueueFamily graphicsQF, const QueueFamily presentQF, const QueueFamily transferQF, const QueueFamily computeQF) noexcept;
+    void setGraphicsPipelineLibraryEnabled(const bool isEnabled) noexcept;
+    // Pipeline builders link pipelines from cached libraries if it's true.
+    bool isGraphicsPipelineLibraryEnabled() const noexcept;
+    void setLimits(const VkPhysicalDeviceLimits &limits) noexcept;
+    // Limits of the physical device the device was created from.
+    const VkPhysicalDeviceLimits &getLimits() const noexcept;
+    void setDescriptorIndexingEnabled(const bool isEnabled) noexcept;
+    // Bindless tables can be created if it's true.
+    bool isDescriptorIndexingEnabled() const noexcept;
+    void loadExtendedDynamicState3Commands() noexcept;
+    bool isExtendedDynamicState3Enabled() const noexcept;
+    const ExtendedDynamicState3Commands &getExtendedDynamicState3Commands() const noexcept;
+    void loadPushDescriptorCommands() noexcept;
+    bool isPushDescriptorEnabled() const noexcept;
+    const PushDescriptorCommands &getPushDescriptorCommands() const noexcept;
+    VkFence createFence(const bool signaled = true) noexcept;
     void waitForFences(const std::vector<VkFence> &fences, const bool waitAll, uint64_t timeout = std::numeric_limits<uint64_t>::max()) noexcept;
     void resetFences(const std::vector<VkFence> &fences) noexcept;
     VkSemaphore createSemaphore() noexcept;
-
-    SamplerPtr createSampler(PhysicalDevice &physicalDevice);
+    VkSemaphore createTimelineSemaphore(const uint64_t initialValue = 0) noexcept;
+    uint64_t getSemaphoreCounterValue(VkSemaphore semaphore) noexcept;
+    // Returns false on timeout.
+    bool waitForSemaphore(VkSemaphore semaphore, const uint64_t value, uint64_t timeout = std::numeric_limits<uint64_t>::max()) noexcept;
+
+    // Recycled synchronization objects for short-lived operations.
+    FencePool &getFencePool() noexcept;
+    SemaphorePool &getSemaphorePool() noexcept;
+    // Used by all pipeline builders. Load it from disk before building pipelines.
+    PipelineCache &getPipelineCache() noexcept;
+    // Shared pipelines and pipeline layouts.
+    PipelineRegistry &getPipelineRegistry() noexcept;
+    // Shader modules shared by pipeline builders.
+    ShaderModuleCache &getShaderModuleCache() noexcept;
+    // Samplers shared by equal descriptions, respecting the sampler limits of the device.
+    SamplerCache &getSamplerCache() noexcept;
+    // Descriptor sets shared by equal contents. Destroyed buffers, image views and samplers invalidate it.
+    DescriptorSetCache &getDescriptorSetCache() noexcept;
 
     template <typename T>
     ObjectPtr<T> createObjectPointer(T objectHandle) {
@@ -74,7 +116,20 @@ public:
 
 private:
     DevicePtr _dev;
-    QueueFamily _graphicsQueueFamily = 0, _presentQueueFamily = 0, _transferQueueFamily = 0;
+    // Declared after the device handle, so they are destroyed before it.
+    std::unique_ptr<FencePool> _fencePool;
+    std::unique_ptr<SemaphorePool> _semaphorePool;
+    std::unique_ptr<PipelineCache> _pipelineCache;
+    std::unique_ptr<PipelineRegistry> _pipelineRegistry;
+    std::unique_ptr<ShaderModuleCache> _shaderModuleCache;
+    std::unique_ptr<SamplerCache> _samplerCache;
+    std::unique_ptr<DescriptorSetCache> _descriptorSetCache;
+    QueueFamily _graphicsQueueFamily = 0, _presentQueueFamily = 0, _transferQueueFamily = 0, _computeQueueFamily = 0;
+    bool _isGraphicsPipelineLibraryEnabled = false;
+    bool _isDescriptorIndexingEnabled = false;
+    VkPhysicalDeviceLimits _limits{};
+    ExtendedDynamicState3Commands _extendedDynamicState3Commands;
+    PushDescriptorCommands _pushDescriptorCommands;
 };
 
 } // namespace vulkan.
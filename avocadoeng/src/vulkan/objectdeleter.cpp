@@ -20,15 +20,24 @@ DEFINE_SPECIALIZATION(DescriptorPool)
 DEFINE_SPECIALIZATION(DescriptorSetLayout)
 DEFINE_SPECIALIZATION(Fence)
 DEFINE_SPECIALIZATION(Image)
-DEFINE_SPECIALIZATION(ImageView)
 DEFINE_SPECIALIZATION(Pipeline)
 DEFINE_SPECIALIZATION(PipelineLayout)
 DEFINE_SPECIALIZATION(RenderPass)
-DEFINE_SPECIALIZATION(Sampler)
 DEFINE_SPECIALIZATION(Semaphore)
 DEFINE_SPECIALIZATION(ShaderModule)
 DEFINE_SPECIALIZATION(SwapchainKHR)
 
+// Cached descriptor sets mustn't outlive what they reference.
+template<> void destroyObject<VkImageView>(LogicalDevice &logicalDevice, VkImageView objHandle) {
+    logicalDevice.getDescriptorSetCache().invalidateImageView(objHandle);
+    vkDestroyImageView(logicalDevice.getHandle(), objHandle, nullptr);
+}
+
+template<> void destroyObject<VkSampler>(LogicalDevice &logicalDevice, VkSampler objHandle) {
+    logicalDevice.getDescriptorSetCache().invalidateSampler(objHandle);
+    vkDestroySampler(logicalDevice.getHandle(), objHandle, nullptr);
+}
+
 template <>
 void freeAllocation<VkDeviceMemory>(LogicalDevice &device, VkDeviceMemory allocatedObjectHandle) noexcept {
     vkFreeMemory(device.getHandle(), allocatedObjectHandle, nullptr);
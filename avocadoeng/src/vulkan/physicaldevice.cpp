@@ -3,12 +3,73 @@
 #include "surface.hpp"
 #include "vkutils.hpp"
 
+#include <algorithm>
 #include <cstring>
 
 using namespace std::literals::string_literals;
 
 namespace avocado::vulkan {
 
+namespace {
+
+// The host-visible window into VRAM without resizable BAR.
+constexpr VkDeviceSize SMALL_BAR_HEAP_SIZE = 256 * 1024 * 1024;
+// Share of a small BAR heap which one allocation may take.
+constexpr VkDeviceSize SMALL_BAR_ALLOCATION_DIVISOR = 16;
+// Protected and lazily allocated memory need resource flags which the engine never sets,
+// device-coherent memory is uncached.
+constexpr VkMemoryPropertyFlags EXCLUDED_MEMORY_FLAGS = VK_MEMORY_PROPERTY_PROTECTED_BIT | VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT |
+    VK_MEMORY_PROPERTY_DEVICE_COHERENT_BIT_AMD;
+
+struct MemoryFlags {
+    VkMemoryPropertyFlags required = 0;
+    VkMemoryPropertyFlags preferred = 0;
+    VkMemoryPropertyFlags avoided = 0;
+};
+
+MemoryFlags getMemoryFlags(const MemoryUsage usage) noexcept {
+    switch (usage) {
+    case MemoryUsage::GpuOnly:
+        // Host-visible VRAM is left to the usages which map it.
+        return {0, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT};
+    case MemoryUsage::Upload:
+        // Write-combined system memory, a transfer reads it once.
+        return {VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, 0,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_CACHED_BIT};
+    case MemoryUsage::Readback:
+        // Uncached reads by the CPU are very slow.
+        return {VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, VK_MEMORY_PROPERTY_HOST_CACHED_BIT,
+            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT};
+    case MemoryUsage::DynamicPerFrame:
+        // Shaders read VRAM faster than system memory over PCIe.
+        return {VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+            VK_MEMORY_PROPERTY_HOST_CACHED_BIT};
+    }
+
+    return {};
+}
+
+uint32_t countBits(VkMemoryPropertyFlags flags) noexcept {
+    uint32_t count = 0;
+    for (; flags != 0; flags &= flags - 1)
+        ++count;
+
+    return count;
+}
+
+QueueFamily findQueueFamily(const std::vector<VkQueueFamilyProperties> &properties,
+    const VkQueueFlags requiredFlags, const VkQueueFlags excludedFlags) noexcept {
+    for (size_t i = 0; i < properties.size(); ++i) {
+        const VkQueueFlags flags = properties[i].queueFlags;
+        if ((flags & requiredFlags) == requiredFlags && (flags & excludedFlags) == 0)
+            return static_cast<QueueFamily>(i);
+    }
+
+    return std::numeric_limits<QueueFamily>::max();
+}
+
+} // namespace.
+
 PhysicalDevice::PhysicalDevice():
     ErrorStorage(),
     _device(VK_NULL_HANDLE) {
@@ -17,6 +78,11 @@ PhysicalDevice::PhysicalDevice():
 PhysicalDevice::PhysicalDevice(VkPhysicalDevice device):
     ErrorStorage(),
     _device(device) {
+    const char *failedCall = nullptr;
+    const VkResult result = PhysicalDeviceCapabilities::query(_device, _capabilities, failedCall);
+    setHasError(result != VK_SUCCESS);
+    if (hasError())
+        setErrorMessage(failedCall + " returned "s + getVkResultString(result));
 }
 
 VkPhysicalDevice PhysicalDevice::getHandle() noexcept {
@@ -27,22 +93,27 @@ bool PhysicalDevice::isValid() const noexcept {
     return (_device != VK_NULL_HANDLE);
 }
 
+const PhysicalDeviceCapabilities &PhysicalDevice::getCapabilities() const noexcept {
+    return _capabilities;
+}
+
+const VkPhysicalDeviceProperties &PhysicalDevice::getProperties() const noexcept {
+    return _capabilities.properties;
+}
+
+VkFormatProperties PhysicalDevice::getFormatProperties(const VkFormat format) const noexcept {
+    return _capabilities.getFormatProperties(format);
+}
+
 void PhysicalDevice::initQueueFamilies(Surface &surface) {
-    uint32_t queueFamilyPropertiesCount = 0;
-    vkGetPhysicalDeviceQueueFamilyProperties(_device, &queueFamilyPropertiesCount, nullptr);
-    if (queueFamilyPropertiesCount > 0) {
-        std::vector<VkQueueFamilyProperties> result(queueFamilyPropertiesCount);
-        vkGetPhysicalDeviceQueueFamilyProperties(_device, &queueFamilyPropertiesCount, result.data());
+    const std::vector<VkQueueFamilyProperties> &result = _capabilities.queueFamilies;
+    if (!result.empty()) {
         VkBool32 presentSupport = VK_FALSE;
         for (size_t i = 0; i < result.size(); ++i) {
             if (_graphicsQueueFamily == std::numeric_limits<QueueFamily>::max() && (result[i].queueFlags & VK_QUEUE_GRAPHICS_BIT)) {
                 _graphicsQueueFamily = static_cast<uint32_t>(i);
             }
 
-            if (_transferQueueFamily == std::numeric_limits<QueueFamily>::max() && (result[i].queueFlags & VK_QUEUE_TRANSFER_BIT)) {
-                _transferQueueFamily = static_cast<uint32_t>(i);
-            }
-
             if (_presentQueueFamily == std::numeric_limits<QueueFamily>::max()) {
                 const VkResult surfSupportResult = vkGetPhysicalDeviceSurfaceSupportKHR(_device, static_cast<uint32_t>(i), surface.getHandle(), &presentSupport);
                 setHasError(surfSupportResult != VK_SUCCESS);
@@ -54,6 +125,19 @@ void PhysicalDevice::initQueueFamilies(Surface &surface) {
                     _presentQueueFamily = static_cast<uint32_t>(i);
             }
         }
+
+        // Prefer a transfer-only family (usually a DMA engine), then any family without graphics.
+        // Graphics queues support transfers implicitly, so the graphics family is the fallback.
+        _transferQueueFamily = findQueueFamily(result, VK_QUEUE_TRANSFER_BIT, VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT);
+        if (_transferQueueFamily == std::numeric_limits<QueueFamily>::max())
+            _transferQueueFamily = findQueueFamily(result, VK_QUEUE_TRANSFER_BIT, VK_QUEUE_GRAPHICS_BIT);
+        if (_transferQueueFamily == std::numeric_limits<QueueFamily>::max())
+            _transferQueueFamily = _graphicsQueueFamily;
+
+        // Async compute needs a family without graphics, otherwise compute runs on the graphics queue.
+        _computeQueueFamily = findQueueFamily(result, VK_QUEUE_COMPUTE_BIT, VK_QUEUE_GRAPHICS_BIT);
+        if (_computeQueueFamily == std::numeric_limits<QueueFamily>::max())
+            _computeQueueFamily = _graphicsQueueFamily;
     }
 }
 
@@ -69,6 +153,18 @@ QueueFamily PhysicalDevice::getTransferQueueFamily() const noexcept {
     return _transferQueueFamily;
 }
 
+QueueFamily PhysicalDevice::getComputeQueueFamily() const noexcept {
+    return _computeQueueFamily;
+}
+
+bool PhysicalDevice::hasDedicatedTransferQueueFamily() const noexcept {
+    return (_transferQueueFamily != _graphicsQueueFamily);
+}
+
+bool PhysicalDevice::hasDedicatedComputeQueueFamily() const noexcept {
+    return (_computeQueueFamily != _graphicsQueueFamily);
+}
+
 LogicalDevice PhysicalDevice::createLogicalDevice(
     const std::vector<uint32_t> &uniqueQueueFamilyIndices,
     const std::vector<std::string> &extensions,
@@ -87,7 +183,70 @@ LogicalDevice PhysicalDevice::createLogicalDevice(
         extensionsCString[i] = extensions[i].c_str();
     }
 
+    // Timeline semaphores are core since Vulkan 1.2 and drive the frame scheduler.
+    // Synchronization2 is core since Vulkan 1.3 and used for batched submissions.
+    VkPhysicalDeviceVulkan13Features vulkan13Features{}; FILL_S_TYPE(vulkan13Features);
+    vulkan13Features.synchronization2 = VK_TRUE;
+    // Lets pipeline creation fail instead of compiling, which module identifiers rely on.
+    vulkan13Features.pipelineCreationCacheControl = _capabilities.vulkan13Features.pipelineCreationCacheControl;
+
+    VkPhysicalDeviceVulkan12Features vulkan12Features{}; FILL_S_TYPE(vulkan12Features);
+    vulkan12Features.pNext = &vulkan13Features;
+
+    // Anisotropic filtering is enabled if the device has it, samplers fall back to plain filtering otherwise.
+    const VkBool32 isSamplerAnisotropySupported = _capabilities.features.samplerAnisotropy;
+    VkPhysicalDeviceFeatures2 features{}; FILL_S_TYPE(features);
+    features.pNext = &vulkan12Features;
+    features.features.samplerAnisotropy = isSamplerAnisotropySupported;
+    vulkan12Features.timelineSemaphore = VK_TRUE;
+
+    // Bindless tables, enabled whenever the device supports them since no extension is needed.
+    const bool isDescriptorIndexingEnabled = isDescriptorIndexingSupported();
+    if (isDescriptorIndexingEnabled) {
+        vulkan12Features.runtimeDescriptorArray = VK_TRUE;
+        vulkan12Features.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
+        vulkan12Features.shaderStorageBufferArrayNonUniformIndexing = VK_TRUE;
+        vulkan12Features.descriptorBindingPartiallyBound = VK_TRUE;
+        vulkan12Features.descriptorBindingUpdateUnusedWhilePending = VK_TRUE;
+        vulkan12Features.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+        vulkan12Features.descriptorBindingStorageBufferUpdateAfterBind = VK_TRUE;
+    }
+
+    // Features of optional extensions are enabled if the extension is requested.
+    const auto isExtensionRequested = [&extensions](const char *extName) {
+        return std::find(extensions.begin(), extensions.end(), extName) != extensions.end();
+    };
+
+    // Pipelines are linked from libraries.
+    const bool isGraphicsPipelineLibraryEnabled = isExtensionRequested(VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME);
+    VkPhysicalDeviceGraphicsPipelineLibraryFeaturesEXT graphicsPipelineLibraryFeatures{}; FILL_S_TYPE(graphicsPipelineLibraryFeatures);
+    graphicsPipelineLibraryFeatures.graphicsPipelineLibrary = VK_TRUE;
+    if (isGraphicsPipelineLibraryEnabled) {
+        graphicsPipelineLibraryFeatures.pNext = vulkan13Features.pNext;
+        vulkan13Features.pNext = &graphicsPipelineLibraryFeatures;
+    }
+
+    // Blend enables and polygon mode can be dynamic.
+    const bool isExtendedDynamicState3Enabled = isExtensionRequested(VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME);
+    VkPhysicalDeviceExtendedDynamicState3FeaturesEXT extendedDynamicState3Features{}; FILL_S_TYPE(extendedDynamicState3Features);
+    extendedDynamicState3Features.extendedDynamicState3ColorBlendEnable = VK_TRUE;
+    extendedDynamicState3Features.extendedDynamicState3PolygonMode = VK_TRUE;
+    if (isExtendedDynamicState3Enabled) {
+        extendedDynamicState3Features.pNext = vulkan13Features.pNext;
+        vulkan13Features.pNext = &extendedDynamicState3Features;
+    }
+
+    // Cached pipelines are created from module identifiers.
+    const bool isShaderModuleIdentifierEnabled = isExtensionRequested(VK_EXT_SHADER_MODULE_IDENTIFIER_EXTENSION_NAME);
+    VkPhysicalDeviceShaderModuleIdentifierFeaturesEXT shaderModuleIdentifierFeatures{}; FILL_S_TYPE(shaderModuleIdentifierFeatures);
+    shaderModuleIdentifierFeatures.shaderModuleIdentifier = VK_TRUE;
+    if (isShaderModuleIdentifierEnabled) {
+        shaderModuleIdentifierFeatures.pNext = vulkan13Features.pNext;
+        vulkan13Features.pNext = &shaderModuleIdentifierFeatures;
+    }
+
     VkDeviceCreateInfo devCreateInfo{}; FILL_S_TYPE(devCreateInfo);
+    devCreateInfo.pNext = &features;
     devCreateInfo.queueCreateInfoCount = static_cast<decltype(devCreateInfo.queueCreateInfoCount)>(queueCreateInfos.size());
     devCreateInfo.pQueueCreateInfos = queueCreateInfos.data();
     devCreateInfo.enabledExtensionCount = static_cast<decltype(devCreateInfo.enabledExtensionCount)>(extensionsCString.size());
@@ -112,70 +271,84 @@ LogicalDevice PhysicalDevice::createLogicalDevice(
     }
 
     LogicalDevice logicalDevice(logicDevHandle);
-    logicalDevice.setQueueFamilies(getGraphicsQueueFamily(), getPresentQueueFamily(), getTransferQueueFamily());
+    logicalDevice.setQueueFamilies(getGraphicsQueueFamily(), getPresentQueueFamily(), getTransferQueueFamily(), getComputeQueueFamily());
+    logicalDevice.setGraphicsPipelineLibraryEnabled(isGraphicsPipelineLibraryEnabled);
+    logicalDevice.setDescriptorIndexingEnabled(isDescriptorIndexingEnabled);
+    const VkPhysicalDeviceLimits &limits = getProperties().limits;
+    logicalDevice.setLimits(limits);
+    logicalDevice.getSamplerCache().setLimits(isSamplerAnisotropySupported == VK_TRUE ? limits.maxSamplerAnisotropy : 1.f,
+        limits.maxSamplerAllocationCount);
+    if (isExtendedDynamicState3Enabled)
+        logicalDevice.loadExtendedDynamicState3Commands();
+    if (isShaderModuleIdentifierEnabled && vulkan13Features.pipelineCreationCacheControl == VK_TRUE)
+        logicalDevice.getShaderModuleCache().enableModuleIdentifiers();
+    if (isExtensionRequested(VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME))
+        logicalDevice.loadPushDescriptorCommands();
     return logicalDevice;
 }
 
-std::vector<std::string> PhysicalDevice::getPhysicalDeviceExtensions() const {
-    std::vector<std::string> extensions;
-    uint32_t count = std::numeric_limits<uint32_t>::max();
-    const VkResult enumerateDevExt1 = vkEnumerateDeviceExtensionProperties(_device, nullptr, &count, nullptr);
-    setHasError(enumerateDevExt1 != VK_SUCCESS);
-    if (hasError()) {
-        setErrorMessage("VkEnumerateDeviceExtensionProperties returned "s + getVkResultString(enumerateDevExt1));
-        return extensions;
-    }
-
-    if (count > 0) {
-        extensions.resize(count);
-        std::vector<VkExtensionProperties> extProps(count);
-        const VkResult enumerateDevExt2 = vkEnumerateDeviceExtensionProperties(_device, nullptr, &count, extProps.data());
-        setHasError(enumerateDevExt2 != VK_SUCCESS);
-        if (hasError()) {
-            setErrorMessage("VkEnumerateDeviceExtensionProperties returned "s + getVkResultString(enumerateDevExt2));
-            return extensions;
-        }
-
-        for (size_t i = 0; i < extProps.size(); ++i)
-            extensions[i] = extProps[i].extensionName;
-    }
-
-    return extensions;
+const std::vector<std::string> &PhysicalDevice::getPhysicalDeviceExtensions() const noexcept {
+    return _capabilities.extensions;
 }
 
-uint32_t PhysicalDevice::findMemoryTypeIndex(const VkMemoryPropertyFlags memoryFlags, const uint32_t memoryTypeBits) {
-    VkPhysicalDeviceMemoryProperties memProps{};
-    vkGetPhysicalDeviceMemoryProperties(_device, &memProps);
+uint32_t PhysicalDevice::findMemoryTypeIndex(const MemoryUsage usage, const uint32_t memoryTypeBits, const VkDeviceSize size) const noexcept {
+    const VkPhysicalDeviceMemoryProperties &memProps = _capabilities.memoryProperties;
+    const MemoryFlags memoryFlags = getMemoryFlags(usage);
 
-    uint32_t foundIndex = 0;
+    // The type with the fewest missing preferred and present avoided flags wins. Ties keep the first type,
+    // drivers list better types first.
+    uint32_t foundIndex = invalidMemoryTypeIndex;
+    uint32_t foundCost = std::numeric_limits<uint32_t>::max();
     for (uint32_t i = 0; i < memProps.memoryTypeCount; ++i) {
-        if (memoryTypeBits & (1 << i) && (memProps.memoryTypes[i].propertyFlags & memoryFlags) == memoryFlags) {
+        const VkMemoryType &memoryType = memProps.memoryTypes[i];
+        const VkMemoryHeap &memoryHeap = memProps.memoryHeaps[memoryType.heapIndex];
+        if ((memoryTypeBits & (1u << i)) == 0 || (memoryType.propertyFlags & memoryFlags.required) != memoryFlags.required ||
+            (memoryType.propertyFlags & EXCLUDED_MEMORY_FLAGS) != 0 || size > memoryHeap.size)
+            continue;
+
+        // Without resizable BAR big allocations would exhaust the host-visible VRAM, system memory takes them.
+        const bool isBarHeap = ((memoryType.propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) != 0 &&
+            (memoryHeap.flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) != 0);
+        if (isBarHeap && memoryHeap.size <= SMALL_BAR_HEAP_SIZE && size > memoryHeap.size / SMALL_BAR_ALLOCATION_DIVISOR)
+            continue;
+
+        const uint32_t cost = countBits(memoryFlags.preferred & ~memoryType.propertyFlags) +
+            countBits(memoryFlags.avoided & memoryType.propertyFlags);
+        if (cost < foundCost) {
             foundIndex = i;
-            break;
+            foundCost = cost;
         }
     }
 
     return foundIndex;
 }
 
-bool PhysicalDevice::areExtensionsSupported(const std::vector<std::string> &extNames) const {
-    std::vector<std::string> deviceExtensions = getPhysicalDeviceExtensions();
-    if (hasError()) {
-        setErrorMessage("getDeviceExtensions() returned Error ("s + getErrorMessage() + ')');
-        return false;
+VkResult PhysicalDevice::allocateMemory(VkDevice device, const VkMemoryRequirements &requirements, const MemoryUsage usage,
+    VkDeviceMemory &memory) const {
+    VkMemoryAllocateInfo memAllocInfo{}; FILL_S_TYPE(memAllocInfo);
+    memAllocInfo.allocationSize = requirements.size;
+
+    uint32_t memoryTypeBits = requirements.memoryTypeBits;
+    VkResult result = VK_ERROR_FEATURE_NOT_PRESENT;
+    while (result == VK_ERROR_FEATURE_NOT_PRESENT || result == VK_ERROR_OUT_OF_DEVICE_MEMORY) {
+        memAllocInfo.memoryTypeIndex = findMemoryTypeIndex(usage, memoryTypeBits, requirements.size);
+        if (memAllocInfo.memoryTypeIndex == invalidMemoryTypeIndex)
+            break;
+
+        VkDeviceMemory allocatedMemory = VK_NULL_HANDLE;
+        result = vkAllocateMemory(device, &memAllocInfo, nullptr, &allocatedMemory);
+        if (result == VK_SUCCESS)
+            memory = allocatedMemory;
+
+        memoryTypeBits &= ~(1u << memAllocInfo.memoryTypeIndex);
     }
 
-    bool extFound = false;
-    for (const std::string &extName: extNames) {
-        extFound = false;
-        for (const std::string &devExt: deviceExtensions) {
-            if (devExt == extName) {
-                extFound = true;
-                break;
-            }
-        }
+    return result;
+}
 
-        if (!extFound) {
+bool PhysicalDevice::areExtensionsSupported(const std::vector<std::string> &extNames) const {
+    for (const std::string &extName: extNames) {
+        if (!_capabilities.hasExtension(extName.c_str())) {
             setHasError(true);
             setErrorMessage("Physical extension '"s + extName + "' isn't supported");
             return false;
@@ -185,6 +358,34 @@ bool PhysicalDevice::areExtensionsSupported(const std::vector<std::string> &extN
     return true;
 }
 
+bool PhysicalDevice::isGraphicsPipelineLibrarySupported() const {
+    return (_capabilities.hasExtension(VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME) &&
+        _capabilities.graphicsPipelineLibraryFeatures.graphicsPipelineLibrary == VK_TRUE);
+}
 
-} // namespace avocado::vulkan
+bool PhysicalDevice::isExtendedDynamicState3Supported() const {
+    const VkPhysicalDeviceExtendedDynamicState3FeaturesEXT &extendedDynamicState3Features = _capabilities.extendedDynamicState3Features;
+    return (extendedDynamicState3Features.extendedDynamicState3ColorBlendEnable == VK_TRUE &&
+        extendedDynamicState3Features.extendedDynamicState3PolygonMode == VK_TRUE);
+}
+
+bool PhysicalDevice::isPushDescriptorSupported() const {
+    return _capabilities.hasExtension(VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME);
+}
+
+bool PhysicalDevice::isDescriptorIndexingSupported() const {
+    const VkPhysicalDeviceVulkan12Features &vulkan12Features = _capabilities.vulkan12Features;
+    return (vulkan12Features.runtimeDescriptorArray == VK_TRUE &&
+        vulkan12Features.shaderSampledImageArrayNonUniformIndexing == VK_TRUE &&
+        vulkan12Features.shaderStorageBufferArrayNonUniformIndexing == VK_TRUE &&
+        vulkan12Features.descriptorBindingPartiallyBound == VK_TRUE &&
+        vulkan12Features.descriptorBindingUpdateUnusedWhilePending == VK_TRUE &&
+        vulkan12Features.descriptorBindingSampledImageUpdateAfterBind == VK_TRUE &&
+        vulkan12Features.descriptorBindingStorageBufferUpdateAfterBind == VK_TRUE);
+}
+
+bool PhysicalDevice::isShaderModuleIdentifierSupported() const {
+    return (_capabilities.shaderModuleIdentifierFeatures.shaderModuleIdentifier == VK_TRUE);
+}
 
+} // namespace avocado::vulkan
@@ -6,6 +6,7 @@
 
 #include "types.hpp"
 #include "logicaldevice.hpp"
+#include "physicaldevicecapabilities.hpp"
 
 #include <vulkan/vulkan_core.h>
 
@@ -19,18 +20,35 @@ class PhysicalDevice final: public core::ErrorStorage {
 public:
     MAKE_MOVABLE(PhysicalDevice);
 
+    static constexpr uint32_t invalidMemoryTypeIndex = std::numeric_limits<uint32_t>::max();
+
     PhysicalDevice();
+    // Queries the capabilities, nothing below asks the driver again.
     explicit PhysicalDevice(VkPhysicalDevice device);
 
     VkPhysicalDevice getHandle() noexcept;
     bool isValid() const noexcept;
-    std::vector<std::string> getPhysicalDeviceExtensions() const;
-    uint32_t findMemoryTypeIndex(const VkMemoryPropertyFlags memoryFlags, const uint32_t memoryTypeBits);
+    const PhysicalDeviceCapabilities &getCapabilities() const noexcept;
+    const VkPhysicalDeviceProperties &getProperties() const noexcept;
+    VkFormatProperties getFormatProperties(const VkFormat format) const noexcept;
+    const std::vector<std::string> &getPhysicalDeviceExtensions() const noexcept;
+    // Best type of memoryTypeBits for the usage whose heap can hold size bytes, or invalidMemoryTypeIndex.
+    uint32_t findMemoryTypeIndex(const MemoryUsage usage, const uint32_t memoryTypeBits, const VkDeviceSize size) const noexcept;
+    // Falls back to the next best memory type while heaps are full.
+    // Returns VK_ERROR_FEATURE_NOT_PRESENT if no memory type qualifies for the usage
+    // and VK_ERROR_OUT_OF_DEVICE_MEMORY if all qualifying types are full.
+    VkResult allocateMemory(VkDevice device, const VkMemoryRequirements &requirements, const MemoryUsage usage,
+        VkDeviceMemory &memory) const;
 
     void initQueueFamilies(Surface &surface);
     QueueFamily getGraphicsQueueFamily() const noexcept;
     QueueFamily getPresentQueueFamily() const noexcept;
     QueueFamily getTransferQueueFamily() const noexcept;
+    QueueFamily getComputeQueueFamily() const noexcept;
+    // True if uploads can run on a different queue family than rendering.
+    bool hasDedicatedTransferQueueFamily() const noexcept;
+    // True if compute work can run asynchronously to the graphics queue.
+    bool hasDedicatedComputeQueueFamily() const noexcept;
 
     LogicalDevice createLogicalDevice(
         const std::vector<uint32_t> &uniqueQueueFamilyIndices,
@@ -38,14 +56,26 @@ public:
         const std::vector<std::string> &instanceLayers,
         const uint32_t queueCount, const float queuePriority);
     bool areExtensionsSupported(const std::vector<std::string> &extNames) const;
+    // VK_EXT_graphics_pipeline_library with its feature, the extensions aren't required.
+    bool isGraphicsPipelineLibrarySupported() const;
+    // VK_EXT_extended_dynamic_state3 with dynamic blend enables and polygon mode.
+    bool isExtendedDynamicState3Supported() const;
+    // VK_KHR_push_descriptor, it has no feature to check.
+    bool isPushDescriptorSupported() const;
+    // Core descriptor indexing features which BindlessTable needs.
+    bool isDescriptorIndexingSupported() const;
+    // VK_EXT_shader_module_identifier with its feature.
+    bool isShaderModuleIdentifierSupported() const;
 
 private:
     NON_COPYABLE(PhysicalDevice);
 
     VkPhysicalDevice _device;
+    PhysicalDeviceCapabilities _capabilities;
     QueueFamily _graphicsQueueFamily = std::numeric_limits<QueueFamily>::max(),
         _presentQueueFamily = std::numeric_limits<QueueFamily>::max(),
-        _transferQueueFamily = std::numeric_limits<QueueFamily>::max();
+        _transferQueueFamily = std::numeric_limits<QueueFamily>::max(),
+        _computeQueueFamily = std::numeric_limits<QueueFamily>::max();
 };
 
 }
@@ -0,0 +1,110 @@
+#include "physicaldevicecapabilities.hpp"
+
+#include "structuretypes.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace avocado::vulkan {
+
+namespace {
+
+// The last format of core Vulkan 1.0, later core formats have extension-sized values.
+constexpr VkFormat LAST_CORE_FORMAT = VK_FORMAT_ASTC_12x12_SRGB_BLOCK;
+
+VkResult queryExtensions(VkPhysicalDevice device, std::vector<std::string> &extensions) {
+    uint32_t count = 0;
+    VkResult result = vkEnumerateDeviceExtensionProperties(device, nullptr, &count, nullptr);
+    if (result != VK_SUCCESS || count == 0)
+        return result;
+
+    std::vector<VkExtensionProperties> extProps(count);
+    result = vkEnumerateDeviceExtensionProperties(device, nullptr, &count, extProps.data());
+    if (result != VK_SUCCESS)
+        return result;
+
+    extensions.reserve(count);
+    for (uint32_t i = 0; i < count; ++i)
+        extensions.emplace_back(extProps[i].extensionName);
+
+    std::sort(extensions.begin(), extensions.end());
+    return VK_SUCCESS;
+}
+
+} // namespace.
+
+VkResult PhysicalDeviceCapabilities::query(VkPhysicalDevice device, PhysicalDeviceCapabilities &capabilities,
+                                           const char *&failedCall) {
+    capabilities = PhysicalDeviceCapabilities();
+    failedCall = nullptr;
+    const VkResult result = queryExtensions(device, capabilities.extensions);
+    if (result != VK_SUCCESS) {
+        failedCall = "vkEnumerateDeviceExtensionProperties";
+        return result;
+    }
+
+    vkGetPhysicalDeviceProperties(device, &capabilities.properties);
+    vkGetPhysicalDeviceMemoryProperties(device, &capabilities.memoryProperties);
+
+    uint32_t queueFamilyCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(device, &queueFamilyCount, nullptr);
+    capabilities.queueFamilies.resize(queueFamilyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(device, &queueFamilyCount, capabilities.queueFamilies.data());
+
+    // Extension feature structs may only be chained if the device has the extension.
+    VkPhysicalDeviceFeatures2 features{}; FILL_S_TYPE(features);
+    FILL_S_TYPE(capabilities.vulkan11Features);
+    FILL_S_TYPE(capabilities.vulkan12Features);
+    FILL_S_TYPE(capabilities.vulkan13Features);
+    features.pNext = &capabilities.vulkan11Features;
+    capabilities.vulkan11Features.pNext = &capabilities.vulkan12Features;
+    capabilities.vulkan12Features.pNext = &capabilities.vulkan13Features;
+    if (capabilities.hasExtension(VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME)) {
+        FILL_S_TYPE(capabilities.graphicsPipelineLibraryFeatures);
+        capabilities.graphicsPipelineLibraryFeatures.pNext = features.pNext;
+        features.pNext = &capabilities.graphicsPipelineLibraryFeatures;
+    }
+    if (capabilities.hasExtension(VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME)) {
+        FILL_S_TYPE(capabilities.extendedDynamicState3Features);
+        capabilities.extendedDynamicState3Features.pNext = features.pNext;
+        features.pNext = &capabilities.extendedDynamicState3Features;
+    }
+    if (capabilities.hasExtension(VK_EXT_SHADER_MODULE_IDENTIFIER_EXTENSION_NAME)) {
+        FILL_S_TYPE(capabilities.shaderModuleIdentifierFeatures);
+        capabilities.shaderModuleIdentifierFeatures.pNext = features.pNext;
+        features.pNext = &capabilities.shaderModuleIdentifierFeatures;
+    }
+
+    vkGetPhysicalDeviceFeatures2(device, &features);
+    capabilities.features = features.features;
+    // The chain points into this object, it would dangle in a copy.
+    capabilities.vulkan11Features.pNext = nullptr;
+    capabilities.vulkan12Features.pNext = nullptr;
+    capabilities.vulkan13Features.pNext = nullptr;
+    capabilities.graphicsPipelineLibraryFeatures.pNext = nullptr;
+    capabilities.extendedDynamicState3Features.pNext = nullptr;
+    capabilities.shaderModuleIdentifierFeatures.pNext = nullptr;
+
+    // VK_FORMAT_UNDEFINED has no features.
+    capabilities.formatProperties.resize(static_cast<size_t>(LAST_CORE_FORMAT) + 1);
+    for (size_t i = 1; i < capabilities.formatProperties.size(); ++i)
+        vkGetPhysicalDeviceFormatProperties(device, static_cast<VkFormat>(i), &capabilities.formatProperties[i]);
+
+    return VK_SUCCESS;
+}
+
+bool PhysicalDeviceCapabilities::hasExtension(const char *extName) const {
+    const auto it = std::lower_bound(extensions.begin(), extensions.end(), extName,
+        [](const std::string &lhs, const char *rhs) { return std::strcmp(lhs.c_str(), rhs) < 0; });
+    return (it != extensions.end() && *it == extName);
+}
+
+VkFormatProperties PhysicalDeviceCapabilities::getFormatProperties(const VkFormat format) const noexcept {
+    const size_t index = static_cast<size_t>(format);
+    if (index >= formatProperties.size())
+        return VkFormatProperties{};
+
+    return formatProperties[index];
+}
+
+} // namespace avocado::vulkan.
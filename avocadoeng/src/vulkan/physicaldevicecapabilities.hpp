@@ -0,0 +1,40 @@
+#ifndef AVOCADO_VULKAN_PHYSICAL_DEVICE_CAPABILITIES
+#define AVOCADO_VULKAN_PHYSICAL_DEVICE_CAPABILITIES
+
+#include <vulkan/vulkan_core.h>
+
+#include <string>
+#include <vector>
+
+namespace avocado::vulkan {
+
+// Everything the engine asks the driver about a physical device, queried once when the device is enumerated.
+// Feature structs are stored without their pNext chains, so the snapshot can be copied and moved.
+// Features of optional extensions are zeroed if the device doesn't have the extension.
+struct PhysicalDeviceCapabilities {
+    // Fills everything or returns the first failed result, failedCall then names the Vulkan function that failed.
+    static VkResult query(VkPhysicalDevice device, PhysicalDeviceCapabilities &capabilities, const char *&failedCall);
+
+    bool hasExtension(const char *extName) const;
+    // Formats outside the core range aren't in the snapshot and report no features.
+    VkFormatProperties getFormatProperties(const VkFormat format) const noexcept;
+
+    VkPhysicalDeviceProperties properties{};
+    VkPhysicalDeviceFeatures features{};
+    VkPhysicalDeviceVulkan11Features vulkan11Features{};
+    VkPhysicalDeviceVulkan12Features vulkan12Features{};
+    VkPhysicalDeviceVulkan13Features vulkan13Features{};
+    VkPhysicalDeviceGraphicsPipelineLibraryFeaturesEXT graphicsPipelineLibraryFeatures{};
+    VkPhysicalDeviceExtendedDynamicState3FeaturesEXT extendedDynamicState3Features{};
+    VkPhysicalDeviceShaderModuleIdentifierFeaturesEXT shaderModuleIdentifierFeatures{};
+    VkPhysicalDeviceMemoryProperties memoryProperties{};
+    std::vector<VkQueueFamilyProperties> queueFamilies;
+    // Sorted.
+    std::vector<std::string> extensions;
+    // Indexed by VkFormat.
+    std::vector<VkFormatProperties> formatProperties;
+};
+
+} // namespace avocado::vulkan.
+
+#endif
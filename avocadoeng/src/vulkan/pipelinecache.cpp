@@ -0,0 +1,152 @@
+#include "pipelinecache.hpp"
+
+#include "structuretypes.hpp"
+#include "vkutils.hpp"
+
+#include "../utils.hpp"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+
+using namespace std::string_literals;
+
+namespace avocado::vulkan {
+
+namespace {
+
+// The data is produced by another driver, GPU or driver version, or is corrupted.
+bool isCompatible(const std::vector<char> &data, const VkPhysicalDeviceProperties &properties) noexcept {
+    VkPipelineCacheHeaderVersionOne header{};
+    if (data.size() < sizeof(header))
+        return false;
+
+    std::memcpy(&header, data.data(), sizeof(header));
+    return (header.headerSize >= sizeof(header) && header.headerSize <= data.size() &&
+        header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+        header.vendorID == properties.vendorID && header.deviceID == properties.deviceID &&
+        std::memcmp(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE) == 0);
+}
+
+} // namespace.
+
+PipelineCache::PipelineCache(VkDevice device):
+    _device(device) {
+    _cache = createCache({});
+}
+
+PipelineCache::~PipelineCache() {
+    saveIfChanged();
+    destroyCache(_cache);
+}
+
+bool PipelineCache::load(const std::string &filePath, const VkPhysicalDeviceProperties &properties) {
+    {
+        std::lock_guard lock(_mutex);
+        _filePath = filePath;
+    }
+
+    const std::vector<char> data = utils::readFile(filePath);
+    if (!isCompatible(data, properties))
+        return false;
+
+    VkPipelineCache cache = createCache(data);
+    if (hasError())
+        return false;
+
+    std::lock_guard lock(_mutex);
+    destroyCache(_cache);
+    _cache = cache;
+    return true;
+}
+
+void PipelineCache::save() {
+    std::lock_guard lock(_mutex);
+
+    if (_filePath.empty() || _cache == VK_NULL_HANDLE)
+        return;
+
+    size_t dataSize = 0;
+    VkResult result = vkGetPipelineCacheData(_device, _cache, &dataSize, nullptr);
+    std::vector<char> data(dataSize);
+    if (result == VK_SUCCESS)
+        result = vkGetPipelineCacheData(_device, _cache, &dataSize, data.data());
+
+    setHasError(result != VK_SUCCESS);
+    if (hasError()) {
+        setErrorMessage("vkGetPipelineCacheData returned "s + getVkResultString(result));
+        return;
+    }
+
+    // Rename replaces the old file atomically.
+    const std::string tempFilePath = _filePath + ".tmp";
+    std::ofstream file(tempFilePath, std::ios_base::binary | std::ios_base::trunc);
+    file.write(data.data(), static_cast<std::streamsize>(dataSize));
+    file.close();
+    setHasError(!file);
+    if (hasError()) {
+        setErrorMessage("Can't write pipeline cache file "s + tempFilePath);
+        return;
+    }
+
+    std::error_code errorCode;
+    std::filesystem::rename(tempFilePath, _filePath, errorCode);
+    setHasError(static_cast<bool>(errorCode));
+    if (hasError()) {
+        setErrorMessage("Can't replace pipeline cache file: "s + errorCode.message());
+        return;
+    }
+
+    _unsavedPipelineCount = 0;
+}
+
+void PipelineCache::saveIfChanged() {
+    if (_unsavedPipelineCount > 0)
+        save();
+}
+
+void PipelineCache::notifyPipelineCreated() noexcept {
+    ++_unsavedPipelineCount;
+}
+
+VkPipelineCache PipelineCache::createThreadCache() {
+    return createCache({});
+}
+
+void PipelineCache::mergeThreadCache(VkPipelineCache threadCache) {
+    std::lock_guard lock(_mutex);
+
+    const VkResult result = vkMergePipelineCaches(_device, _cache, 1, &threadCache);
+    setHasError(result != VK_SUCCESS);
+    if (hasError())
+        setErrorMessage("vkMergePipelineCaches returned "s + getVkResultString(result));
+    else
+        ++_unsavedPipelineCount;
+
+    destroyCache(threadCache);
+}
+
+VkPipelineCache PipelineCache::getHandle() noexcept {
+    return _cache;
+}
+
+VkPipelineCache PipelineCache::createCache(const std::vector<char> &initialData) {
+    VkPipelineCacheCreateInfo createInfo{}; FILL_S_TYPE(createInfo);
+    createInfo.initialDataSize = initialData.size();
+    createInfo.pInitialData = initialData.data();
+
+    VkPipelineCache cache = VK_NULL_HANDLE;
+    const VkResult result = vkCreatePipelineCache(_device, &createInfo, nullptr, &cache);
+    setHasError(result != VK_SUCCESS);
+    if (hasError())
+        setErrorMessage("vkCreatePipelineCache returned "s + getVkResultString(result));
+
+    return cache;
+}
+
+void PipelineCache::destroyCache(VkPipelineCache cache) noexcept {
+    if (cache != VK_NULL_HANDLE)
+        vkDestroyPipelineCache(_device, cache, nullptr);
+}
+
+} // namespace avocado::vulkan.
@@ -0,0 +1,58 @@
+#ifndef AVOCADO_VULKAN_PIPELINE_CACHE
+#define AVOCADO_VULKAN_PIPELINE_CACHE
+
+#include "../errorstorage.hpp"
+#include "../utils.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace avocado::vulkan {
+
+// VkPipelineCache which survives application restarts. The file is used only if its header
+// matches the device, otherwise the cache starts empty. Saving goes through a temporary file,
+// so a crash while writing never leaves a truncated cache behind.
+// Threads which create many pipelines can use their own caches and merge them afterwards.
+class PipelineCache: public core::ErrorStorage {
+public:
+    NON_COPYABLE(PipelineCache);
+    NON_MOVABLE(PipelineCache);
+
+    explicit PipelineCache(VkDevice device);
+    // Saves the cache if pipelines were created since the last save.
+    ~PipelineCache();
+
+    // Has to be called before any pipeline is created. Returns false if the file is missing or stale.
+    bool load(const std::string &filePath, const VkPhysicalDeviceProperties &properties);
+    void save();
+    // Cheap enough to be called periodically.
+    void saveIfChanged();
+    // Pipeline builders call it after they used the cache.
+    void notifyPipelineCreated() noexcept;
+
+    // Returns an empty cache which doesn't contend with other threads.
+    VkPipelineCache createThreadCache();
+    // Merges the thread cache into this one and destroys it. Nothing may use getHandle() meanwhile.
+    void mergeThreadCache(VkPipelineCache threadCache);
+
+    VkPipelineCache getHandle() noexcept;
+
+private:
+    VkPipelineCache createCache(const std::vector<char> &initialData);
+    void destroyCache(VkPipelineCache cache) noexcept;
+
+    VkDevice _device = VK_NULL_HANDLE;
+    VkPipelineCache _cache = VK_NULL_HANDLE;
+    std::string _filePath;
+    // vkMergePipelineCaches requires the destination to be externally synchronized.
+    std::mutex _mutex;
+    std::atomic<uint32_t> _unsavedPipelineCount = 0;
+};
+
+} // namespace avocado::vulkan.
+
+#endif
@@ -0,0 +1,195 @@
+#include "pipelinecompiler.hpp"
+
+#include "logicaldevice.hpp"
+#include "pipelineregistry.hpp"
+
+#include <chrono>
+
+using namespace std::string_literals;
+
+namespace avocado::vulkan {
+
+namespace {
+
+PipelineFuture makeReadyFuture(VkPipeline pipeline) {
+    std::promise<VkPipeline> promise;
+    promise.set_value(pipeline);
+    return promise.get_future().share();
+}
+
+} // namespace.
+
+PipelineCompiler::PipelineCompiler(LogicalDevice &device, const uint32_t threadCount):
+    _logicalDevice(device) {
+    assert(threadCount > 0);
+
+    _workers.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; ++i)
+        _workers.emplace_back(&PipelineCompiler::runWorker, this);
+}
+
+PipelineCompiler::~PipelineCompiler() {
+    {
+        std::lock_guard lock(_mutex);
+        _isStopping = true;
+    }
+    _jobAvailable.notify_all();
+
+    for (std::thread &worker : _workers)
+        worker.join();
+}
+
+PipelineFuture PipelineCompiler::compile(PipelineRequest request) {
+    GraphicsPipelineBuilder &builder = *request.builder;
+    std::string key = builder.createStateKey(request.renderPass);
+
+    // Pipelines created synchronously, or replaced by optimized ones, are in the registry.
+    const VkPipeline existingPipeline = _logicalDevice.getPipelineRegistry().findGraphicsPipeline(key);
+    if (existingPipeline != VK_NULL_HANDLE)
+        return makeReadyFuture(existingPipeline);
+
+    const auto it = _requestedPipelines.find(key);
+    if (it != _requestedPipelines.end()) {
+        // A failed request is tried again.
+        const PipelineFuture &future = it->second;
+        const bool isFailed = (future.wait_for(std::chrono::seconds(0)) == std::future_status::ready &&
+            future.get() == VK_NULL_HANDLE);
+        if (!isFailed)
+            return future;
+
+        _requestedPipelines.erase(it);
+    }
+
+    // The registry isn't used by workers for layouts, its error state belongs to this thread.
+    setHasError(builder.preparePipelineLayout() == VK_NULL_HANDLE);
+    if (hasError()) {
+        setErrorMessage("Can't prepare pipeline: "s + builder.getErrorMessage());
+        return makeReadyFuture(VK_NULL_HANDLE);
+    }
+
+    Job job;
+    job.request = std::move(request);
+    job.key = key;
+    PipelineFuture future = job.promise.get_future().share();
+    _requestedPipelines.emplace(std::move(key), future);
+
+    {
+        std::lock_guard lock(_mutex);
+        _jobs.push_back(std::move(job));
+        ++_pendingCount;
+    }
+    _jobAvailable.notify_one();
+
+    return future;
+}
+
+std::vector<PipelineFuture> PipelineCompiler::precompile(std::vector<PipelineRequest> requests) {
+    std::vector<PipelineFuture> futures;
+    futures.reserve(requests.size());
+    for (PipelineRequest &request : requests)
+        futures.push_back(compile(std::move(request)));
+
+    return futures;
+}
+
+VkPipeline PipelineCompiler::tryGet(const PipelineFuture &future) {
+    if (!future.valid() || future.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        return VK_NULL_HANDLE;
+
+    return future.get();
+}
+
+size_t PipelineCompiler::getPendingCount() const {
+    std::lock_guard lock(_mutex);
+    return _pendingCount;
+}
+
+void PipelineCompiler::waitIdle() {
+    std::unique_lock lock(_mutex);
+    _jobDone.wait(lock, [this]() { return _pendingCount == 0; });
+}
+
+size_t PipelineCompiler::getFailedCount() const {
+    std::lock_guard lock(_mutex);
+    return _failedCount;
+}
+
+std::string PipelineCompiler::getLastFailureMessage() const {
+    std::lock_guard lock(_mutex);
+    return _lastFailureMessage;
+}
+
+void PipelineCompiler::runWorker() {
+    while (true) {
+        Job job;
+        bool isStopping = false;
+        {
+            std::unique_lock lock(_mutex);
+            _jobAvailable.wait(lock, [this]() { return _isStopping || !_jobs.empty(); });
+            // Queued jobs are finished before stopping, nobody would set their promises otherwise.
+            if (_jobs.empty())
+                return;
+
+            job = std::move(_jobs.front());
+            _jobs.pop_front();
+            isStopping = _isStopping;
+        }
+
+        if (!job.isOptimizedRelink) {
+            const VkPipeline pipeline = build(job);
+            job.promise.set_value(pipeline);
+            if (pipeline != VK_NULL_HANDLE && job.request.isOptimizedRelinkEnabled && job.request.builder->isFastLinked()) {
+                // The job stays pending until the optimized pipeline is linked.
+                job.isOptimizedRelink = true;
+                {
+                    std::lock_guard lock(_mutex);
+                    _jobs.push_back(std::move(job));
+                }
+                _jobAvailable.notify_one();
+                continue;
+            }
+        } else if (!isStopping) {
+            // The fast-linked pipeline works, so relinks are skipped on shutdown.
+            relink(job);
+        }
+
+        // The builder owns the pipeline states, free them before the job is reported as done.
+        job.request.builder.reset();
+
+        {
+            std::lock_guard lock(_mutex);
+            --_pendingCount;
+        }
+        _jobDone.notify_all();
+    }
+}
+
+VkPipeline PipelineCompiler::build(Job &job) {
+    GraphicsPipelineBuilder &builder = *job.request.builder;
+    PipelinePtr pipeline = builder.buildPipeline(job.request.renderPass);
+    if (builder.hasError()) {
+        addFailure(builder.getErrorMessage());
+        return VK_NULL_HANDLE;
+    }
+
+    return _logicalDevice.getPipelineRegistry().addGraphicsPipeline(job.key, pipeline.release());
+}
+
+void PipelineCompiler::relink(Job &job) {
+    GraphicsPipelineBuilder &builder = *job.request.builder;
+    PipelinePtr pipeline = builder.buildOptimizedPipeline();
+    if (builder.hasError()) {
+        addFailure("Optimized relink failed: "s + builder.getErrorMessage());
+        return;
+    }
+
+    _logicalDevice.getPipelineRegistry().replaceGraphicsPipeline(std::move(job.key), pipeline.release());
+}
+
+void PipelineCompiler::addFailure(const std::string &message) {
+    std::lock_guard lock(_mutex);
+    ++_failedCount;
+    _lastFailureMessage = message;
+}
+
+} // namespace avocado::vulkan.
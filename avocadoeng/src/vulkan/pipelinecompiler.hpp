@@ -0,0 +1,92 @@
+#ifndef AVOCADO_VULKAN_PIPELINE_COMPILER
+#define AVOCADO_VULKAN_PIPELINE_COMPILER
+
+#include "../errorstorage.hpp"
+#include "../utils.hpp"
+
+#include "graphicspipeline.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace avocado::vulkan {
+
+// Holds VK_NULL_HANDLE if the pipeline couldn't be created.
+using PipelineFuture = std::shared_future<VkPipeline>;
+
+struct PipelineRequest {
+    std::unique_ptr<GraphicsPipelineBuilder> builder;
+    VkRenderPass renderPass = VK_NULL_HANDLE;
+    // A fast-linked pipeline is replaced in the registry by an optimized one once it's linked.
+    bool isOptimizedRelinkEnabled = true;
+};
+
+// Creates graphics pipelines on worker threads, so the thread which asks for a pipeline doesn't stall
+// while the driver compiles shaders. Finished pipelines are owned by the device pipeline registry.
+// Workers compile into the device pipeline cache, which is internally synchronized, so pipelines loaded
+// from disk are found and newly compiled ones are saved with the next PipelineCache::saveIfChanged().
+// All functions except tryGet() are called from one thread.
+class PipelineCompiler: public core::ErrorStorage {
+public:
+    NON_COPYABLE(PipelineCompiler);
+    NON_MOVABLE(PipelineCompiler);
+
+    PipelineCompiler(LogicalDevice &device, const uint32_t threadCount);
+    // Finishes queued requests, except optimized relinks.
+    ~PipelineCompiler();
+
+    // Returns immediately. The future is ready at once if the pipeline exists or failed to get a layout.
+    PipelineFuture compile(PipelineRequest request);
+    // Queues all known permutations, e.g. during a loading screen. Futures are in request order.
+    std::vector<PipelineFuture> precompile(std::vector<PipelineRequest> requests);
+    // Returns VK_NULL_HANDLE until the pipeline is ready, so a draw can be skipped or use a simpler pipeline.
+    static VkPipeline tryGet(const PipelineFuture &future);
+
+    size_t getPendingCount() const;
+    void waitIdle();
+
+    // Workers can't report through ErrorStorage, so failed requests are counted here.
+    size_t getFailedCount() const;
+    std::string getLastFailureMessage() const;
+
+private:
+    struct Job {
+        PipelineRequest request;
+        std::string key;
+        std::promise<VkPipeline> promise;
+        bool isOptimizedRelink = false;
+    };
+
+    void runWorker();
+    VkPipeline build(Job &job);
+    void relink(Job &job);
+    void addFailure(const std::string &message);
+
+    LogicalDevice &_logicalDevice;
+    std::vector<std::thread> _workers;
+    // Requested pipelines, so the same state isn't compiled twice while a request is in flight.
+    std::unordered_map<std::string, PipelineFuture> _requestedPipelines;
+
+    mutable std::mutex _mutex;
+    std::condition_variable _jobAvailable;
+    std::condition_variable _jobDone;
+    std::deque<Job> _jobs;
+    // Queued and running jobs.
+    size_t _pendingCount = 0;
+    bool _isStopping = false;
+    size_t _failedCount = 0;
+    std::string _lastFailureMessage;
+};
+
+} // namespace avocado::vulkan.
+
+#endif
@@ -0,0 +1,145 @@
+#include "pipelineregistry.hpp"
+
+#include "graphicspipeline.hpp"
+#include "structuretypes.hpp"
+#include "vkutils.hpp"
+
+#include <utility>
+
+using namespace std::string_literals;
+
+namespace avocado::vulkan {
+
+PipelineRegistry::PipelineRegistry(VkDevice device):
+    _device(device) {
+}
+
+PipelineRegistry::~PipelineRegistry() {
+    for (const auto &[key, pipeline] : _pipelines)
+        vkDestroyPipeline(_device, pipeline, nullptr);
+
+    for (VkPipeline pipeline : _replacedPipelines)
+        vkDestroyPipeline(_device, pipeline, nullptr);
+
+    for (const auto &[key, library] : _pipelineLibraries)
+        vkDestroyPipeline(_device, library, nullptr);
+
+    for (const auto &[key, pipelineLayout] : _pipelineLayouts)
+        vkDestroyPipelineLayout(_device, pipelineLayout, nullptr);
+}
+
+VkPipelineLayout PipelineRegistry::getPipelineLayout(const std::vector<VkDescriptorSetLayout> &setLayouts,
+    const std::vector<VkPushConstantRange> &pushConstantRanges) {
+    setHasError(false);
+    std::string key;
+    utils::appendKeyBytes(key, setLayouts);
+    utils::appendKeyBytes(key, pushConstantRanges);
+
+    std::lock_guard lock(_mutex);
+    const auto it = _pipelineLayouts.find(key);
+    if (it != _pipelineLayouts.end())
+        return it->second;
+
+    VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo{}; FILL_S_TYPE(pipelineLayoutCreateInfo);
+    pipelineLayoutCreateInfo.setLayoutCount = static_cast<uint32_t>(setLayouts.size());
+    pipelineLayoutCreateInfo.pSetLayouts = setLayouts.data();
+    pipelineLayoutCreateInfo.pushConstantRangeCount = static_cast<uint32_t>(pushConstantRanges.size());
+    pipelineLayoutCreateInfo.pPushConstantRanges = pushConstantRanges.data();
+
+    VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
+    const VkResult result = vkCreatePipelineLayout(_device, &pipelineLayoutCreateInfo, nullptr, &pipelineLayout);
+    setHasError(result != VK_SUCCESS);
+    if (hasError()) {
+        setErrorMessage("vkCreatePipelineLayout returned "s + getVkResultString(result));
+        return VK_NULL_HANDLE;
+    }
+
+    _pipelineLayouts.emplace(std::move(key), pipelineLayout);
+    return pipelineLayout;
+}
+
+VkPipeline PipelineRegistry::getGraphicsPipeline(GraphicsPipelineBuilder &builder, VkRenderPass renderPass) {
+    // Callers read the layout from the builder, a cached pipeline doesn't set it.
+    setHasError(builder.preparePipelineLayout() == VK_NULL_HANDLE);
+    if (hasError()) {
+        setErrorMessage("Can't prepare pipeline: "s + builder.getErrorMessage());
+        return VK_NULL_HANDLE;
+    }
+
+    std::string key = builder.createStateKey(renderPass);
+    const VkPipeline existingPipeline = findGraphicsPipeline(key);
+    if (existingPipeline != VK_NULL_HANDLE)
+        return existingPipeline;
+
+    PipelinePtr pipeline = builder.buildPipeline(renderPass);
+    setHasError(builder.hasError());
+    if (hasError()) {
+        setErrorMessage("Can't build graphics pipeline: "s + builder.getErrorMessage());
+        return VK_NULL_HANDLE;
+    }
+
+    return addGraphicsPipeline(std::move(key), pipeline.release());
+}
+
+VkPipeline PipelineRegistry::findGraphicsPipeline(const std::string &key) {
+    return findPipeline(_pipelines, key);
+}
+
+VkPipeline PipelineRegistry::addGraphicsPipeline(std::string key, VkPipeline pipeline) {
+    return addPipeline(_pipelines, std::move(key), pipeline);
+}
+
+void PipelineRegistry::replaceGraphicsPipeline(std::string key, VkPipeline pipeline) {
+    std::lock_guard lock(_mutex);
+    VkPipeline &storedPipeline = _pipelines[std::move(key)];
+    if (storedPipeline != VK_NULL_HANDLE)
+        _replacedPipelines.push_back(storedPipeline);
+
+    storedPipeline = pipeline;
+    ++_generation;
+}
+
+uint64_t PipelineRegistry::getGeneration() const {
+    std::lock_guard lock(_mutex);
+    return _generation;
+}
+
+std::vector<VkPipeline> PipelineRegistry::takeReplacedPipelines() {
+    std::lock_guard lock(_mutex);
+    return std::exchange(_replacedPipelines, {});
+}
+
+VkPipeline PipelineRegistry::findPipelineLibrary(const std::string &key) {
+    return findPipeline(_pipelineLibraries, key);
+}
+
+VkPipeline PipelineRegistry::addPipelineLibrary(std::string key, VkPipeline library) {
+    return addPipeline(_pipelineLibraries, std::move(key), library);
+}
+
+size_t PipelineRegistry::getPipelineCount() const {
+    std::lock_guard lock(_mutex);
+    return _pipelines.size();
+}
+
+size_t PipelineRegistry::getPipelineLayoutCount() const {
+    std::lock_guard lock(_mutex);
+    return _pipelineLayouts.size();
+}
+
+VkPipeline PipelineRegistry::findPipeline(const std::unordered_map<std::string, VkPipeline> &pipelines, const std::string &key) {
+    std::lock_guard lock(_mutex);
+    const auto it = pipelines.find(key);
+    return (it != pipelines.end() ? it->second : VK_NULL_HANDLE);
+}
+
+VkPipeline PipelineRegistry::addPipeline(std::unordered_map<std::string, VkPipeline> &pipelines, std::string key, VkPipeline pipeline) {
+    std::lock_guard lock(_mutex);
+    const auto [it, isInserted] = pipelines.emplace(std::move(key), pipeline);
+    if (!isInserted)
+        vkDestroyPipeline(_device, pipeline, nullptr);
+
+    return it->second;
+}
+
+} // namespace avocado::vulkan.
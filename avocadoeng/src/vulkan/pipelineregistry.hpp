@@ -0,0 +1,70 @@
+#ifndef AVOCADO_VULKAN_PIPELINE_REGISTRY
+#define AVOCADO_VULKAN_PIPELINE_REGISTRY
+
+#include "../errorstorage.hpp"
+#include "../utils.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace avocado::vulkan {
+
+class GraphicsPipelineBuilder;
+
+// Owns pipelines and pipeline layouts, and returns the existing object when the same state is
+// requested again. Materials which share state share the pipeline, so they can be drawn without
+// rebinding it. Objects live as long as the registry, unless replaced pipelines are taken over.
+// Lookups are thread-safe. Error state is set only by the get*() functions, so they are called
+// from one thread, while pipeline compiler workers use addGraphicsPipeline().
+class PipelineRegistry: public core::ErrorStorage {
+public:
+    NON_COPYABLE(PipelineRegistry);
+    NON_MOVABLE(PipelineRegistry);
+
+    explicit PipelineRegistry(VkDevice device);
+    ~PipelineRegistry();
+
+    VkPipelineLayout getPipelineLayout(const std::vector<VkDescriptorSetLayout> &setLayouts,
+        const std::vector<VkPushConstantRange> &pushConstantRanges = {});
+    // The builder is used only if no pipeline with its state exists yet.
+    VkPipeline getGraphicsPipeline(GraphicsPipelineBuilder &builder, VkRenderPass renderPass);
+    // Returns VK_NULL_HANDLE if there is no pipeline with the key.
+    VkPipeline findGraphicsPipeline(const std::string &key);
+    // Takes ownership of the pipeline. If another thread added the same state first,
+    // the given pipeline is destroyed and the existing one is returned.
+    VkPipeline addGraphicsPipeline(std::string key, VkPipeline pipeline);
+    // Keeps the replaced pipeline alive, recorded command buffers may still use it. Bumps the generation.
+    void replaceGraphicsPipeline(std::string key, VkPipeline pipeline);
+    // Changes whenever a pipeline is replaced, so users of found pipelines know when to look them up again.
+    uint64_t getGeneration() const;
+    // Hands the replaced pipelines over to the caller, who destroys them once the GPU is done with the work
+    // which was recorded before the pipelines were looked up again, e.g. with FrameScheduler::retire().
+    std::vector<VkPipeline> takeReplacedPipelines();
+    // Pipeline libraries are shared by all pipelines which are linked from them.
+    VkPipeline findPipelineLibrary(const std::string &key);
+    VkPipeline addPipelineLibrary(std::string key, VkPipeline library);
+
+    size_t getPipelineCount() const;
+    size_t getPipelineLayoutCount() const;
+
+private:
+    VkPipeline findPipeline(const std::unordered_map<std::string, VkPipeline> &pipelines, const std::string &key);
+    VkPipeline addPipeline(std::unordered_map<std::string, VkPipeline> &pipelines, std::string key, VkPipeline pipeline);
+
+    VkDevice _device = VK_NULL_HANDLE;
+    mutable std::mutex _mutex;
+    // Keys are the serialized states, so equal keys always mean equal objects.
+    std::unordered_map<std::string, VkPipelineLayout> _pipelineLayouts;
+    std::unordered_map<std::string, VkPipeline> _pipelines;
+    std::unordered_map<std::string, VkPipeline> _pipelineLibraries;
+    std::vector<VkPipeline> _replacedPipelines;
+    uint64_t _generation = 0;
+};
+
+} // namespace avocado::vulkan.
+
+#endif
@@ -1,5 +1,6 @@
 #include "queue.hpp"
 
+#include "submissionbuilder.hpp"
 #include "vkutils.hpp"
 
 #include <vulkan/vulkan_core.h>
@@ -53,6 +54,18 @@ void Queue::submit(const VkSubmitInfo &submitInfo, VkFence fence) noexcept {
     }
 }
 
+void Queue::submit(SubmissionBuilder &submission, VkFence fence) {
+    assert(getHandle() != VK_NULL_HANDLE);
+
+    const std::vector<VkSubmitInfo2> submitInfos = submission.createSubmitInfos();
+    const VkResult result = vkQueueSubmit2(getHandle(), static_cast<uint32_t>(submitInfos.size()), submitInfos.data(), fence);
+    submission.clear();
+    setHasError(result != VK_SUCCESS);
+    if (hasError()) {
+        setErrorMessage("vkQueueSubmit2 returned "s + getVkResultString(result));
+    }
+}
+
 void Queue::present(VkSemaphore &waitSemaphore, uint32_t &imageIndex, VkSwapchainKHR &swapchain) {
     VkPresentInfoKHR presentInfo{}; FILL_S_TYPE(presentInfo);
 
@@ -8,6 +8,7 @@
 namespace avocado::vulkan {
 
 class CommandBuffer;
+class SubmissionBuilder;
 
 struct VkQueue_T;
 
@@ -22,6 +23,8 @@ public:
     VkSubmitInfo createSubmitInfo(VkSemaphore &waitSemaphore, VkSemaphore &signalSemaphore, VkCommandBuffer &commandBuffer,
         const std::vector<VkPipelineStageFlags> &flags);
     void submit(const VkSubmitInfo &submitInfo, VkFence fence = VK_NULL_HANDLE) noexcept;
+    // Flushes all batches with one vkQueueSubmit2 call and clears the builder.
+    void submit(SubmissionBuilder &submission, VkFence fence = VK_NULL_HANDLE);
     void present(VkSemaphore &waitSemaphore, uint32_t &imageIndex, VkSwapchainKHR &swapchain);
 
 private:
@@ -0,0 +1,379 @@
+#include "resourcestatetracker.hpp"
+
+#include "structuretypes.hpp"
+
+#include <algorithm>
+#include <cassert>
+
+namespace avocado::vulkan {
+
+namespace {
+
+constexpr VkAccessFlags2 WriteAccessMask = VK_ACCESS_2_SHADER_WRITE_BIT | VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT |
+    VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT | VK_ACCESS_2_TRANSFER_WRITE_BIT | VK_ACCESS_2_HOST_WRITE_BIT |
+    VK_ACCESS_2_MEMORY_WRITE_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT;
+
+bool hasSameDependency(const VkImageMemoryBarrier2 &a, const VkImageMemoryBarrier2 &b) noexcept {
+    return (a.image == b.image && a.srcStageMask == b.srcStageMask && a.srcAccessMask == b.srcAccessMask &&
+        a.dstStageMask == b.dstStageMask && a.dstAccessMask == b.dstAccessMask && a.oldLayout == b.oldLayout &&
+        a.newLayout == b.newLayout && a.srcQueueFamilyIndex == b.srcQueueFamilyIndex &&
+        a.dstQueueFamilyIndex == b.dstQueueFamilyIndex && a.subresourceRange.aspectMask == b.subresourceRange.aspectMask);
+}
+
+bool hasSameDependency(const VkBufferMemoryBarrier2 &a, const VkBufferMemoryBarrier2 &b) noexcept {
+    return (a.buffer == b.buffer && a.srcStageMask == b.srcStageMask && a.srcAccessMask == b.srcAccessMask &&
+        a.dstStageMask == b.dstStageMask && a.dstAccessMask == b.dstAccessMask &&
+        a.srcQueueFamilyIndex == b.srcQueueFamilyIndex && a.dstQueueFamilyIndex == b.dstQueueFamilyIndex);
+}
+
+} // namespace.
+
+bool ResourceStateTracker::State::operator==(const State &other) const noexcept {
+    return (writeStages == other.writeStages && writeAccess == other.writeAccess && readStages == other.readStages &&
+        readAccess == other.readAccess && layout == other.layout && queueFamily == other.queueFamily);
+}
+
+bool ResourceStateTracker::Transition::operator==(const Transition &other) const noexcept {
+    return (srcStages == other.srcStages && srcAccess == other.srcAccess && dstStages == other.dstStages &&
+        dstAccess == other.dstAccess && oldLayout == other.oldLayout && newLayout == other.newLayout &&
+        srcQueueFamily == other.srcQueueFamily && dstQueueFamily == other.dstQueueFamily);
+}
+
+void ResourceStateTracker::registerImage(VkImage image, const VkImageAspectFlags aspectMask, const uint32_t mipLevels,
+    const uint32_t arrayLayers, const VkImageLayout layout, const QueueFamily queueFamily) {
+    assert(image != VK_NULL_HANDLE && mipLevels > 0 && arrayLayers > 0);
+
+    State state;
+    state.layout = layout;
+    state.queueFamily = queueFamily;
+
+    ImageEntry &entry = _images[image];
+    entry.aspectMask = aspectMask;
+    entry.mipLevels = mipLevels;
+    entry.arrayLayers = arrayLayers;
+    entry.subresources.assign(static_cast<size_t>(mipLevels) * arrayLayers, state);
+}
+
+void ResourceStateTracker::registerBuffer(VkBuffer buffer, const VkDeviceSize size, const QueueFamily queueFamily) {
+    assert(buffer != VK_NULL_HANDLE && size > 0);
+
+    BufferRange range;
+    range.size = size;
+    range.state.queueFamily = queueFamily;
+
+    BufferEntry &entry = _buffers[buffer];
+    entry.size = size;
+    entry.ranges.assign(1, range);
+}
+
+void ResourceStateTracker::unregisterImage(VkImage image) {
+    _images.erase(image);
+}
+
+void ResourceStateTracker::unregisterBuffer(VkBuffer buffer) {
+    _buffers.erase(buffer);
+}
+
+bool ResourceStateTracker::isImageRegistered(VkImage image) const noexcept {
+    return (_images.find(image) != _images.end());
+}
+
+bool ResourceStateTracker::isBufferRegistered(VkBuffer buffer) const noexcept {
+    return (_buffers.find(buffer) != _buffers.end());
+}
+
+void ResourceStateTracker::useImage(VkImage image, const ResourceUsage &usage) {
+    useImage(image, usage, getWholeRange(image));
+}
+
+void ResourceStateTracker::useImage(VkImage image, const ResourceUsage &usage, const VkImageSubresourceRange &range) {
+    // Images can't be transitioned to the undefined layout.
+    assert(usage.layout != VK_IMAGE_LAYOUT_UNDEFINED);
+
+    forEachSubresource(image, range, [&usage](State &state, Transition &transition) {
+        return applyUsage(state, usage, true, transition);
+    });
+}
+
+void ResourceStateTracker::useBuffer(VkBuffer buffer, const ResourceUsage &usage, const VkDeviceSize offset, const VkDeviceSize size) {
+    forEachBufferRange(buffer, offset, size, [&usage](State &state, Transition &transition) {
+        return applyUsage(state, usage, false, transition);
+    });
+}
+
+void ResourceStateTracker::releaseImage(VkImage image, const VkImageLayout newLayout, const QueueFamily srcQueueFamily,
+    const QueueFamily dstQueueFamily) {
+    assert(newLayout != VK_IMAGE_LAYOUT_UNDEFINED);
+
+    forEachSubresource(image, getWholeRange(image), [=](State &state, Transition &transition) {
+        transition = applyRelease(state, newLayout, srcQueueFamily, dstQueueFamily);
+        return true;
+    });
+}
+
+void ResourceStateTracker::releaseBuffer(VkBuffer buffer, const QueueFamily srcQueueFamily, const QueueFamily dstQueueFamily) {
+    forEachBufferRange(buffer, 0, VK_WHOLE_SIZE, [=](State &state, Transition &transition) {
+        transition = applyRelease(state, VK_IMAGE_LAYOUT_UNDEFINED, srcQueueFamily, dstQueueFamily);
+        return true;
+    });
+}
+
+bool ResourceStateTracker::hasPendingBarriers() const noexcept {
+    return (!_pendingBufferBarriers.empty() || !_pendingImageBarriers.empty());
+}
+
+bool ResourceStateTracker::hasPendingBarriers(VkImage image) const noexcept {
+    return std::any_of(_pendingImageBarriers.begin(), _pendingImageBarriers.end(),
+        [image](const VkImageMemoryBarrier2 &barrier) { return barrier.image == image; });
+}
+
+const std::vector<VkBufferMemoryBarrier2> &ResourceStateTracker::getPendingBufferBarriers() const noexcept {
+    return _pendingBufferBarriers;
+}
+
+const std::vector<VkImageMemoryBarrier2> &ResourceStateTracker::getPendingImageBarriers() const noexcept {
+    return _pendingImageBarriers;
+}
+
+void ResourceStateTracker::clearPendingBarriers() noexcept {
+    _pendingBufferBarriers.clear();
+    _pendingImageBarriers.clear();
+}
+
+VkImageLayout ResourceStateTracker::getImageLayout(VkImage image, const uint32_t mipLevel, const uint32_t arrayLayer) const {
+    const auto it = _images.find(image);
+    assert(it != _images.end());
+
+    const ImageEntry &entry = it->second;
+    assert(mipLevel < entry.mipLevels && arrayLayer < entry.arrayLayers);
+    return entry.subresources[static_cast<size_t>(mipLevel) * entry.arrayLayers + arrayLayer].layout;
+}
+
+bool ResourceStateTracker::applyUsage(State &state, const ResourceUsage &usage, const bool hasLayout, Transition &transition) noexcept {
+    const bool isLayoutChange = (hasLayout && usage.layout != state.layout);
+    const bool isWrite = ((usage.access & WriteAccessMask) != 0);
+
+    transition.dstStages = usage.stages;
+    transition.dstAccess = usage.access;
+    transition.oldLayout = state.layout;
+    transition.newLayout = (hasLayout ? usage.layout : state.layout);
+
+    if (!isLayoutChange && !isWrite) {
+        // Read after read needs no barrier. Read after write needs one only for stages and accesses
+        // which didn't see the write yet.
+        const bool isVisible = ((usage.stages & ~state.readStages) == 0 && (usage.access & ~state.readAccess) == 0);
+        state.readStages |= usage.stages;
+        state.readAccess |= usage.access;
+        if (state.writeStages == VK_PIPELINE_STAGE_2_NONE || isVisible)
+            return false;
+
+        transition.srcStages = state.writeStages;
+        transition.srcAccess = state.writeAccess;
+        return true;
+    }
+
+    // Reads only have to be finished before the write, so they add no source access.
+    transition.srcStages = state.writeStages | state.readStages;
+    transition.srcAccess = state.writeAccess;
+    const bool hasPrecedingAccess = (transition.srcStages != VK_PIPELINE_STAGE_2_NONE);
+
+    state.layout = transition.newLayout;
+    state.writeStages = usage.stages;
+    if (isWrite) {
+        state.writeAccess = usage.access & WriteAccessMask;
+        state.readStages = VK_PIPELINE_STAGE_2_NONE;
+        state.readAccess = VK_ACCESS_2_NONE;
+    } else {
+        // The layout transition is the write, the barrier already made it visible to the usage.
+        state.writeAccess = VK_ACCESS_2_NONE;
+        state.readStages = usage.stages;
+        state.readAccess = usage.access;
+    }
+
+    return (isLayoutChange || hasPrecedingAccess);
+}
+
+ResourceStateTracker::Transition ResourceStateTracker::applyRelease(State &state, const VkImageLayout newLayout,
+    const QueueFamily srcQueueFamily, const QueueFamily dstQueueFamily) noexcept {
+    assert(state.queueFamily == VK_QUEUE_FAMILY_IGNORED || state.queueFamily == srcQueueFamily);
+
+    Transition transition;
+    transition.srcStages = state.writeStages | state.readStages;
+    transition.srcAccess = state.writeAccess;
+    transition.oldLayout = state.layout;
+    transition.newLayout = newLayout;
+    transition.srcQueueFamily = srcQueueFamily;
+    transition.dstQueueFamily = dstQueueFamily;
+
+    // Further accesses belong to the destination queue.
+    state = State();
+    state.layout = newLayout;
+    state.queueFamily = dstQueueFamily;
+    return transition;
+}
+
+VkImageMemoryBarrier2 ResourceStateTracker::createImageBarrier(VkImage image, const Transition &transition,
+    const VkImageSubresourceRange &range) noexcept {
+    VkImageMemoryBarrier2 barrier{}; FILL_S_TYPE(barrier);
+    barrier.srcStageMask = transition.srcStages;
+    barrier.srcAccessMask = transition.srcAccess;
+    barrier.dstStageMask = transition.dstStages;
+    barrier.dstAccessMask = transition.dstAccess;
+    barrier.oldLayout = transition.oldLayout;
+    barrier.newLayout = transition.newLayout;
+    barrier.srcQueueFamilyIndex = transition.srcQueueFamily;
+    barrier.dstQueueFamilyIndex = transition.dstQueueFamily;
+    barrier.image = image;
+    barrier.subresourceRange = range;
+    return barrier;
+}
+
+VkBufferMemoryBarrier2 ResourceStateTracker::createBufferBarrier(VkBuffer buffer, const Transition &transition,
+    const VkDeviceSize offset, const VkDeviceSize size) noexcept {
+    VkBufferMemoryBarrier2 barrier{}; FILL_S_TYPE(barrier);
+    barrier.srcStageMask = transition.srcStages;
+    barrier.srcAccessMask = transition.srcAccess;
+    barrier.dstStageMask = transition.dstStages;
+    barrier.dstAccessMask = transition.dstAccess;
+    barrier.srcQueueFamilyIndex = transition.srcQueueFamily;
+    barrier.dstQueueFamilyIndex = transition.dstQueueFamily;
+    barrier.buffer = buffer;
+    barrier.offset = offset;
+    barrier.size = size;
+    return barrier;
+}
+
+void ResourceStateTracker::splitBufferRange(BufferEntry &entry, const VkDeviceSize position) {
+    for (size_t i = 0; i < entry.ranges.size(); ++i) {
+        BufferRange &range = entry.ranges[i];
+        if (position <= range.offset || position >= range.offset + range.size)
+            continue;
+
+        BufferRange tail = range;
+        tail.offset = position;
+        tail.size = range.offset + range.size - position;
+        range.size = position - range.offset;
+        entry.ranges.insert(entry.ranges.begin() + static_cast<std::ptrdiff_t>(i) + 1, tail);
+        return;
+    }
+}
+
+void ResourceStateTracker::mergeBufferRanges(BufferEntry &entry) {
+    size_t last = 0;
+    for (size_t i = 1; i < entry.ranges.size(); ++i) {
+        if (entry.ranges[i].state == entry.ranges[last].state) {
+            entry.ranges[last].size += entry.ranges[i].size;
+        } else {
+            entry.ranges[++last] = entry.ranges[i];
+        }
+    }
+
+    entry.ranges.resize(last + 1);
+}
+
+VkImageSubresourceRange ResourceStateTracker::getWholeRange(VkImage image) const {
+    const auto it = _images.find(image);
+    assert(it != _images.end());
+
+    VkImageSubresourceRange range{};
+    range.aspectMask = it->second.aspectMask;
+    range.levelCount = it->second.mipLevels;
+    range.layerCount = it->second.arrayLayers;
+    return range;
+}
+
+template<typename Function>
+void ResourceStateTracker::forEachSubresource(VkImage image, const VkImageSubresourceRange &range, Function function) {
+    const auto it = _images.find(image);
+    assert(it != _images.end());
+
+    ImageEntry &entry = it->second;
+    const uint32_t levelCount = (range.levelCount == VK_REMAINING_MIP_LEVELS ? entry.mipLevels - range.baseMipLevel : range.levelCount);
+    const uint32_t layerCount = (range.layerCount == VK_REMAINING_ARRAY_LAYERS ? entry.arrayLayers - range.baseArrayLayer : range.layerCount);
+    assert(range.baseMipLevel + levelCount <= entry.mipLevels && range.baseArrayLayer + layerCount <= entry.arrayLayers);
+
+    VkImageSubresourceRange barrierRange{};
+    barrierRange.aspectMask = entry.aspectMask;
+    barrierRange.levelCount = 1;
+    for (uint32_t mipLevel = range.baseMipLevel; mipLevel < range.baseMipLevel + levelCount; ++mipLevel) {
+        barrierRange.baseMipLevel = mipLevel;
+
+        // Consecutive layers with the same transition become one barrier.
+        Transition runTransition;
+        bool hasRun = false;
+        for (uint32_t arrayLayer = range.baseArrayLayer; arrayLayer < range.baseArrayLayer + layerCount; ++arrayLayer) {
+            State &state = entry.subresources[static_cast<size_t>(mipLevel) * entry.arrayLayers + arrayLayer];
+            Transition transition;
+            const bool needsBarrier = function(state, transition);
+            if (hasRun && (!needsBarrier || !(transition == runTransition))) {
+                barrierRange.layerCount = arrayLayer - barrierRange.baseArrayLayer;
+                addImageBarrier(createImageBarrier(image, runTransition, barrierRange));
+                hasRun = false;
+            }
+
+            if (needsBarrier && !hasRun) {
+                runTransition = transition;
+                barrierRange.baseArrayLayer = arrayLayer;
+                hasRun = true;
+            }
+        }
+
+        if (hasRun) {
+            barrierRange.layerCount = range.baseArrayLayer + layerCount - barrierRange.baseArrayLayer;
+            addImageBarrier(createImageBarrier(image, runTransition, barrierRange));
+        }
+    }
+}
+
+template<typename Function>
+void ResourceStateTracker::forEachBufferRange(VkBuffer buffer, const VkDeviceSize offset, const VkDeviceSize size, Function function) {
+    const auto it = _buffers.find(buffer);
+    assert(it != _buffers.end());
+
+    BufferEntry &entry = it->second;
+    const VkDeviceSize end = (size == VK_WHOLE_SIZE ? entry.size : offset + size);
+    assert(offset < end && end <= entry.size);
+
+    splitBufferRange(entry, offset);
+    splitBufferRange(entry, end);
+    for (BufferRange &range : entry.ranges) {
+        if (range.offset < offset || range.offset >= end)
+            continue;
+
+        Transition transition;
+        if (function(range.state, transition))
+            addBufferBarrier(createBufferBarrier(buffer, transition, range.offset, range.size));
+    }
+
+    mergeBufferRanges(entry);
+}
+
+void ResourceStateTracker::addImageBarrier(const VkImageMemoryBarrier2 &barrier) {
+    if (!_pendingImageBarriers.empty()) {
+        VkImageMemoryBarrier2 &last = _pendingImageBarriers.back();
+        VkImageSubresourceRange &lastRange = last.subresourceRange;
+        const VkImageSubresourceRange &range = barrier.subresourceRange;
+        // Same layers of the next mip level.
+        if (hasSameDependency(last, barrier) && lastRange.baseArrayLayer == range.baseArrayLayer &&
+            lastRange.layerCount == range.layerCount && lastRange.baseMipLevel + lastRange.levelCount == range.baseMipLevel) {
+            lastRange.levelCount += range.levelCount;
+            return;
+        }
+    }
+
+    _pendingImageBarriers.push_back(barrier);
+}
+
+void ResourceStateTracker::addBufferBarrier(const VkBufferMemoryBarrier2 &barrier) {
+    if (!_pendingBufferBarriers.empty()) {
+        VkBufferMemoryBarrier2 &last = _pendingBufferBarriers.back();
+        if (hasSameDependency(last, barrier) && last.offset + last.size == barrier.offset) {
+            last.size += barrier.size;
+            return;
+        }
+    }
+
+    _pendingBufferBarriers.push_back(barrier);
+}
+
+} // namespace avocado::vulkan.
@@ -0,0 +1,145 @@
+#ifndef AVOCADO_VULKAN_RESOURCE_STATE_TRACKER
+#define AVOCADO_VULKAN_RESOURCE_STATE_TRACKER
+
+#include "commandbuffer.hpp"
+#include "types.hpp"
+
+#include "../utils.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <unordered_map>
+#include <vector>
+
+namespace avocado::vulkan {
+
+// How the following commands use a resource. The layout is ignored for buffers.
+struct ResourceUsage {
+    VkPipelineStageFlags2 stages = VK_PIPELINE_STAGE_2_NONE;
+    VkAccessFlags2 access = VK_ACCESS_2_NONE;
+    VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
+};
+
+// Remembers the layout, the last write and the reads since it for every image subresource
+// and buffer range, and queues only the barriers the next use actually needs.
+// Read after read in the same layout needs none. Queued barriers are merged over adjacent
+// subresources and ranges and recorded with a single vkCmdPipelineBarrier2 call.
+// Barriers recorded with one call are not ordered between each other, so a subresource
+// should be used at most once between two flushes.
+class ResourceStateTracker {
+public:
+    NON_COPYABLE(ResourceStateTracker);
+
+    ResourceStateTracker() = default;
+    ResourceStateTracker(ResourceStateTracker &&) = default;
+    ResourceStateTracker &operator=(ResourceStateTracker &&) = default;
+
+    void registerImage(VkImage image, const VkImageAspectFlags aspectMask, const uint32_t mipLevels, const uint32_t arrayLayers,
+        const VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED, const QueueFamily queueFamily = VK_QUEUE_FAMILY_IGNORED);
+    void registerBuffer(VkBuffer buffer, const VkDeviceSize size, const QueueFamily queueFamily = VK_QUEUE_FAMILY_IGNORED);
+    void unregisterImage(VkImage image);
+    void unregisterBuffer(VkBuffer buffer);
+    bool isImageRegistered(VkImage image) const noexcept;
+    bool isBufferRegistered(VkBuffer buffer) const noexcept;
+
+    // The layout of an image usage can't be VK_IMAGE_LAYOUT_UNDEFINED.
+    void useImage(VkImage image, const ResourceUsage &usage);
+    // Counts of VK_REMAINING_MIP_LEVELS and VK_REMAINING_ARRAY_LAYERS are supported, the aspect mask is the registered one.
+    void useImage(VkImage image, const ResourceUsage &usage, const VkImageSubresourceRange &range);
+    void useBuffer(VkBuffer buffer, const ResourceUsage &usage, const VkDeviceSize offset = 0, const VkDeviceSize size = VK_WHOLE_SIZE);
+
+    // Release half of a queue family ownership transfer. The acquire half is recorded on the destination queue.
+    void releaseImage(VkImage image, const VkImageLayout newLayout, const QueueFamily srcQueueFamily, const QueueFamily dstQueueFamily);
+    void releaseBuffer(VkBuffer buffer, const QueueFamily srcQueueFamily, const QueueFamily dstQueueFamily);
+
+    // Defined here, so the tracker can be used without linking command recording.
+    inline void flushBarriers(CommandBuffer &commandBuffer) {
+        if (!hasPendingBarriers())
+            return;
+
+        commandBuffer.pipelineBarrier2(_pendingBufferBarriers, _pendingImageBarriers);
+        clearPendingBarriers();
+    }
+    bool hasPendingBarriers() const noexcept;
+    // A second use of the image has to wait for a flush, barriers of one flush aren't ordered.
+    bool hasPendingBarriers(VkImage image) const noexcept;
+    const std::vector<VkBufferMemoryBarrier2> &getPendingBufferBarriers() const noexcept;
+    const std::vector<VkImageMemoryBarrier2> &getPendingImageBarriers() const noexcept;
+    void clearPendingBarriers() noexcept;
+
+    VkImageLayout getImageLayout(VkImage image, const uint32_t mipLevel = 0, const uint32_t arrayLayer = 0) const;
+
+private:
+    struct State {
+        VkPipelineStageFlags2 writeStages = VK_PIPELINE_STAGE_2_NONE;
+        VkAccessFlags2 writeAccess = VK_ACCESS_2_NONE;
+        // Reads since the last write. The writes were already made visible to the reads.
+        VkPipelineStageFlags2 readStages = VK_PIPELINE_STAGE_2_NONE;
+        VkAccessFlags2 readAccess = VK_ACCESS_2_NONE;
+        VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
+        QueueFamily queueFamily = VK_QUEUE_FAMILY_IGNORED;
+
+        bool operator==(const State &other) const noexcept;
+    };
+
+    struct Transition {
+        VkPipelineStageFlags2 srcStages = VK_PIPELINE_STAGE_2_NONE;
+        VkAccessFlags2 srcAccess = VK_ACCESS_2_NONE;
+        VkPipelineStageFlags2 dstStages = VK_PIPELINE_STAGE_2_NONE;
+        VkAccessFlags2 dstAccess = VK_ACCESS_2_NONE;
+        VkImageLayout oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        VkImageLayout newLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        QueueFamily srcQueueFamily = VK_QUEUE_FAMILY_IGNORED;
+        QueueFamily dstQueueFamily = VK_QUEUE_FAMILY_IGNORED;
+
+        bool operator==(const Transition &other) const noexcept;
+    };
+
+    struct ImageEntry {
+        VkImageAspectFlags aspectMask = 0;
+        uint32_t mipLevels = 0;
+        uint32_t arrayLayers = 0;
+        // Indexed by mipLevel * arrayLayers + arrayLayer.
+        std::vector<State> subresources;
+    };
+
+    struct BufferRange {
+        VkDeviceSize offset = 0;
+        VkDeviceSize size = 0;
+        State state;
+    };
+
+    struct BufferEntry {
+        VkDeviceSize size = 0;
+        // Sorted, they don't overlap and cover the whole buffer.
+        std::vector<BufferRange> ranges;
+    };
+
+    // Returns false when the usage needs no barrier.
+    static bool applyUsage(State &state, const ResourceUsage &usage, const bool hasLayout, Transition &transition) noexcept;
+    static Transition applyRelease(State &state, const VkImageLayout newLayout, const QueueFamily srcQueueFamily,
+        const QueueFamily dstQueueFamily) noexcept;
+    static VkImageMemoryBarrier2 createImageBarrier(VkImage image, const Transition &transition,
+        const VkImageSubresourceRange &range) noexcept;
+    static VkBufferMemoryBarrier2 createBufferBarrier(VkBuffer buffer, const Transition &transition,
+        const VkDeviceSize offset, const VkDeviceSize size) noexcept;
+    static void splitBufferRange(BufferEntry &entry, const VkDeviceSize position);
+    static void mergeBufferRanges(BufferEntry &entry);
+
+    VkImageSubresourceRange getWholeRange(VkImage image) const;
+    template<typename Function>
+    void forEachSubresource(VkImage image, const VkImageSubresourceRange &range, Function function);
+    template<typename Function>
+    void forEachBufferRange(VkBuffer buffer, const VkDeviceSize offset, const VkDeviceSize size, Function function);
+    void addImageBarrier(const VkImageMemoryBarrier2 &barrier);
+    void addBufferBarrier(const VkBufferMemoryBarrier2 &barrier);
+
+    std::unordered_map<VkImage, ImageEntry> _images;
+    std::unordered_map<VkBuffer, BufferEntry> _buffers;
+    std::vector<VkBufferMemoryBarrier2> _pendingBufferBarriers;
+    std::vector<VkImageMemoryBarrier2> _pendingImageBarriers;
+};
+
+} // namespace avocado::vulkan.
+
+#endif
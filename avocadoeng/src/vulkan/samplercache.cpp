@@ -0,0 +1,96 @@
+#include "samplercache.hpp"
+
+#include "vkutils.hpp"
+
+#include <algorithm>
+
+using namespace std::string_literals;
+
+namespace avocado::vulkan {
+
+SamplerCache::SamplerCache(VkDevice device):
+    _device(device) {
+}
+
+SamplerCache::~SamplerCache() {
+    for (const auto &[key, sampler] : _samplers)
+        vkDestroySampler(_device, sampler, nullptr);
+}
+
+void SamplerCache::setLimits(const float maxSamplerAnisotropy, const uint32_t maxSamplerAllocationCount) noexcept {
+    _maxSamplerAnisotropy = maxSamplerAnisotropy;
+    _maxSamplerAllocationCount = maxSamplerAllocationCount;
+}
+
+VkSampler SamplerCache::getSampler(const SamplerDescription &description) {
+    // Anisotropy above the limit gives the same sampler as the limit.
+    SamplerDescription clampedDescription = description;
+    clampedDescription.maxAnisotropy = std::clamp(description.maxAnisotropy, 1.f, _maxSamplerAnisotropy);
+
+    std::string key = createKey(clampedDescription);
+    const auto it = _samplers.find(key);
+    if (it != _samplers.end()) {
+        setHasError(false);
+        return it->second;
+    }
+
+    setHasError(_samplers.size() >= _maxSamplerAllocationCount);
+    if (hasError()) {
+        setErrorMessage("maxSamplerAllocationCount "s + std::to_string(_maxSamplerAllocationCount) + " is reached");
+        return VK_NULL_HANDLE;
+    }
+
+    VkSamplerCreateInfo samplerCI{}; FILL_S_TYPE(samplerCI);
+    samplerCI.magFilter = clampedDescription.magFilter;
+    samplerCI.minFilter = clampedDescription.minFilter;
+    samplerCI.mipmapMode = clampedDescription.mipmapMode;
+    samplerCI.addressModeU = clampedDescription.addressModeU;
+    samplerCI.addressModeV = clampedDescription.addressModeV;
+    samplerCI.addressModeW = clampedDescription.addressModeW;
+    samplerCI.mipLodBias = clampedDescription.mipLodBias;
+    samplerCI.anisotropyEnable = (clampedDescription.maxAnisotropy > 1.f ? VK_TRUE : VK_FALSE);
+    samplerCI.maxAnisotropy = clampedDescription.maxAnisotropy;
+    samplerCI.compareEnable = (clampedDescription.compareEnable ? VK_TRUE : VK_FALSE);
+    samplerCI.compareOp = clampedDescription.compareOp;
+    samplerCI.minLod = clampedDescription.minLod;
+    samplerCI.maxLod = clampedDescription.maxLod;
+    samplerCI.borderColor = clampedDescription.borderColor;
+    samplerCI.unnormalizedCoordinates = (clampedDescription.unnormalizedCoordinates ? VK_TRUE : VK_FALSE);
+
+    VkSampler sampler = VK_NULL_HANDLE;
+    const VkResult result = vkCreateSampler(_device, &samplerCI, nullptr, &sampler);
+    setHasError(result != VK_SUCCESS);
+    if (hasError()) {
+        setErrorMessage("vkCreateSampler returned "s + getVkResultString(result));
+        return VK_NULL_HANDLE;
+    }
+
+    _samplers.emplace(std::move(key), sampler);
+    return sampler;
+}
+
+size_t SamplerCache::getSamplerCount() const noexcept {
+    return _samplers.size();
+}
+
+std::string SamplerCache::createKey(const SamplerDescription &description) {
+    // Fields are appended one by one, padding bytes of the struct would make equal descriptions differ.
+    std::string key;
+    utils::appendKeyBytes(key, description.magFilter);
+    utils::appendKeyBytes(key, description.minFilter);
+    utils::appendKeyBytes(key, description.mipmapMode);
+    utils::appendKeyBytes(key, description.addressModeU);
+    utils::appendKeyBytes(key, description.addressModeV);
+    utils::appendKeyBytes(key, description.addressModeW);
+    utils::appendKeyBytes(key, description.mipLodBias);
+    utils::appendKeyBytes(key, description.maxAnisotropy);
+    utils::appendKeyBytes(key, description.compareEnable);
+    utils::appendKeyBytes(key, description.compareOp);
+    utils::appendKeyBytes(key, description.minLod);
+    utils::appendKeyBytes(key, description.maxLod);
+    utils::appendKeyBytes(key, description.borderColor);
+    utils::appendKeyBytes(key, description.unnormalizedCoordinates);
+    return key;
+}
+
+} // namespace avocado::vulkan.
@@ -0,0 +1,65 @@
+#ifndef AVOCADO_VULKAN_SAMPLER_CACHE
+#define AVOCADO_VULKAN_SAMPLER_CACHE
+
+#include "../errorstorage.hpp"
+#include "../utils.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <string>
+#include <unordered_map>
+
+namespace avocado::vulkan {
+
+// Everything a sampler is created from.
+struct SamplerDescription {
+    VkFilter magFilter = VK_FILTER_LINEAR;
+    VkFilter minFilter = VK_FILTER_LINEAR;
+    VkSamplerMipmapMode mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR;
+    VkSamplerAddressMode addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+    VkSamplerAddressMode addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+    VkSamplerAddressMode addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT;
+    float mipLodBias = 0.f;
+    // Anisotropic filtering is used if it's greater than 1. It's clamped to the device limit.
+    float maxAnisotropy = 1.f;
+    bool compareEnable = false;
+    VkCompareOp compareOp = VK_COMPARE_OP_ALWAYS;
+    float minLod = 0.f;
+    float maxLod = VK_LOD_CLAMP_NONE;
+    VkBorderColor borderColor = VK_BORDER_COLOR_INT_OPAQUE_BLACK;
+    bool unnormalizedCoordinates = false;
+};
+
+// Samplers shared by everything which samples with the same description. They are immutable and live
+// as long as the cache, so they can be used as immutable samplers of descriptor set layouts. Not thread safe.
+class SamplerCache: public core::ErrorStorage {
+public:
+    NON_COPYABLE(SamplerCache);
+    NON_MOVABLE(SamplerCache);
+
+    explicit SamplerCache(VkDevice device);
+    ~SamplerCache();
+
+    // The physical device creates the logical device with these.
+    // maxSamplerAnisotropy is 1 if the samplerAnisotropy feature isn't enabled.
+    void setLimits(const float maxSamplerAnisotropy, const uint32_t maxSamplerAllocationCount) noexcept;
+
+    // Creates the sampler the first time the description is seen.
+    // Returns VK_NULL_HANDLE if maxSamplerAllocationCount samplers exist already.
+    VkSampler getSampler(const SamplerDescription &description);
+
+    size_t getSamplerCount() const noexcept;
+
+private:
+    static std::string createKey(const SamplerDescription &description);
+
+    VkDevice _device = VK_NULL_HANDLE;
+    float _maxSamplerAnisotropy = 1.f;
+    // Vulkan guarantees at least 4000.
+    uint32_t _maxSamplerAllocationCount = 4000;
+    std::unordered_map<std::string, VkSampler> _samplers;
+};
+
+} // namespace avocado::vulkan.
+
+#endif
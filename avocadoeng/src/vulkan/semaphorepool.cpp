@@ -0,0 +1,47 @@
+#include "semaphorepool.hpp"
+
+#include "vkutils.hpp"
+
+using namespace std::string_literals;
+
+namespace avocado::vulkan {
+
+SemaphorePool::SemaphorePool(VkDevice device):
+    _device(device) {
+}
+
+SemaphorePool::~SemaphorePool() {
+    for (VkSemaphore semaphore : _semaphores)
+        vkDestroySemaphore(_device, semaphore, nullptr);
+}
+
+VkSemaphore SemaphorePool::acquire() {
+    if (!_freeSemaphores.empty()) {
+        VkSemaphore semaphore = _freeSemaphores.back();
+        _freeSemaphores.pop_back();
+        return semaphore;
+    }
+
+    VkSemaphoreCreateInfo semaphoreCI{}; FILL_S_TYPE(semaphoreCI);
+    VkSemaphore semaphore = VK_NULL_HANDLE;
+    const VkResult result = vkCreateSemaphore(_device, &semaphoreCI, nullptr, &semaphore);
+    setHasError(result != VK_SUCCESS);
+    if (hasError()) {
+        setErrorMessage("vkCreateSemaphore returned "s + getVkResultString(result));
+        return VK_NULL_HANDLE;
+    }
+
+    _semaphores.push_back(semaphore);
+    return semaphore;
+}
+
+void SemaphorePool::release(VkSemaphore semaphore) {
+    if (semaphore != VK_NULL_HANDLE)
+        _freeSemaphores.push_back(semaphore);
+}
+
+size_t SemaphorePool::getCreatedCount() const noexcept {
+    return _semaphores.size();
+}
+
+} // namespace avocado::vulkan.
@@ -0,0 +1,37 @@
+#ifndef AVOCADO_VULKAN_SEMAPHORE_POOL
+#define AVOCADO_VULKAN_SEMAPHORE_POOL
+
+#include "../errorstorage.hpp"
+#include "../utils.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <vector>
+
+namespace avocado::vulkan {
+
+// Hands out binary semaphores and reuses released ones. The state of a binary semaphore
+// can't be queried, so it has to be released only after the work using it is done
+// (see FrameScheduler::acquireSemaphore()). Not thread safe.
+class SemaphorePool: public core::ErrorStorage {
+public:
+    NON_COPYABLE(SemaphorePool);
+    NON_MOVABLE(SemaphorePool);
+
+    explicit SemaphorePool(VkDevice device);
+    ~SemaphorePool();
+
+    VkSemaphore acquire();
+    void release(VkSemaphore semaphore);
+
+    size_t getCreatedCount() const noexcept;
+
+private:
+    VkDevice _device = VK_NULL_HANDLE;
+    std::vector<VkSemaphore> _semaphores;
+    std::vector<VkSemaphore> _freeSemaphores;
+};
+
+} // namespace avocado::vulkan.
+
+#endif
@@ -0,0 +1,142 @@
+#include "shadermodulecache.hpp"
+
+#include "structuretypes.hpp"
+#include "vkutils.hpp"
+
+#include <cstring>
+
+using namespace std::string_literals;
+
+namespace avocado::vulkan {
+
+SpirvView::SpirvView(const std::vector<char> &code) noexcept:
+    _data(code.data()),
+    _size(code.size()) {
+}
+
+SpirvView::SpirvView(const char *data, const size_t size) noexcept:
+    _data(data),
+    _size(size) {
+}
+
+const char *SpirvView::getData() const noexcept {
+    return _data;
+}
+
+size_t SpirvView::getSize() const noexcept {
+    return _size;
+}
+
+ShaderModuleCache::ShaderModuleCache(VkDevice device):
+    _device(device) {
+}
+
+ShaderModuleCache::~ShaderModuleCache() {
+    for (const auto &[hash, entry] : _entries) {
+        if (entry.shaderModule != VK_NULL_HANDLE)
+            vkDestroyShaderModule(_device, entry.shaderModule, nullptr);
+    }
+}
+
+void ShaderModuleCache::enableModuleIdentifiers() noexcept {
+    _getModuleIdentifier = reinterpret_cast<PFN_vkGetShaderModuleCreateInfoIdentifierEXT>(
+        vkGetDeviceProcAddr(_device, "vkGetShaderModuleCreateInfoIdentifierEXT"));
+}
+
+bool ShaderModuleCache::areModuleIdentifiersEnabled() const noexcept {
+    return (_getModuleIdentifier != nullptr);
+}
+
+uint64_t ShaderModuleCache::addCode(const SpirvView code) {
+    const uint64_t hash = utils::hashBytes(code.getData(), code.getSize());
+
+    std::lock_guard lock(_mutex);
+    setHasError(false);
+    const auto [it, isInserted] = _entries.try_emplace(hash);
+    Entry &entry = it->second;
+    if (!isInserted) {
+        setHasError(entry.code.size() != code.getSize() || std::memcmp(entry.code.data(), code.getData(), code.getSize()) != 0);
+        if (hasError())
+            setErrorMessage("Different shader code has the same hash "s + std::to_string(hash));
+
+        return hash;
+    }
+
+    entry.code.assign(code.getData(), code.getData() + code.getSize());
+    if (_getModuleIdentifier != nullptr) {
+        VkShaderModuleCreateInfo shaderModuleCreateInfo{}; FILL_S_TYPE(shaderModuleCreateInfo);
+        shaderModuleCreateInfo.codeSize = entry.code.size();
+        shaderModuleCreateInfo.pCode = reinterpret_cast<const uint32_t*>(entry.code.data());
+
+        FILL_S_TYPE(entry.identifier);
+        _getModuleIdentifier(_device, &shaderModuleCreateInfo, &entry.identifier);
+    }
+
+    return hash;
+}
+
+uint64_t ShaderModuleCache::addFile(const std::string &filePath) {
+    {
+        std::lock_guard lock(_mutex);
+        setHasError(false);
+        const auto it = _fileHashes.find(filePath);
+        if (it != _fileHashes.end())
+            return it->second;
+    }
+
+    const std::vector<char> code = utils::readFile(filePath);
+    if (code.empty()) {
+        std::lock_guard lock(_mutex);
+        setHasError(true);
+        setErrorMessage("Can't read shader file "s + filePath);
+        return 0;
+    }
+
+    const uint64_t hash = addCode(code);
+    std::lock_guard lock(_mutex);
+    _fileHashes.emplace(filePath, hash);
+    return hash;
+}
+
+VkResult ShaderModuleCache::getShaderModule(const uint64_t hash, VkShaderModule &shaderModule) {
+    std::lock_guard lock(_mutex);
+    const auto it = _entries.find(hash);
+    if (it == _entries.end())
+        return VK_ERROR_INITIALIZATION_FAILED;
+
+    Entry &entry = it->second;
+    if (entry.shaderModule == VK_NULL_HANDLE) {
+        VkShaderModuleCreateInfo shaderModuleCreateInfo{}; FILL_S_TYPE(shaderModuleCreateInfo);
+        shaderModuleCreateInfo.codeSize = entry.code.size();
+        shaderModuleCreateInfo.pCode = reinterpret_cast<const uint32_t*>(entry.code.data());
+
+        VkShaderModule createdShaderModule = VK_NULL_HANDLE;
+        const VkResult result = vkCreateShaderModule(_device, &shaderModuleCreateInfo, nullptr, &createdShaderModule);
+        if (result != VK_SUCCESS)
+            return result;
+
+        entry.shaderModule = createdShaderModule;
+    }
+
+    shaderModule = entry.shaderModule;
+    return VK_SUCCESS;
+}
+
+const VkShaderModuleIdentifierEXT *ShaderModuleCache::getModuleIdentifier(const uint64_t hash) const {
+    if (_getModuleIdentifier == nullptr)
+        return nullptr;
+
+    std::lock_guard lock(_mutex);
+    const auto it = _entries.find(hash);
+    if (it == _entries.end() || it->second.identifier.identifierSize == 0)
+        return nullptr;
+
+    return &it->second.identifier;
+}
+
+size_t ShaderModuleCache::getCodeCount() const {
+    std::lock_guard lock(_mutex);
+    return _entries.size();
+}
+
+} // namespace avocado::vulkan.
@@ -0,0 +1,75 @@
+#ifndef AVOCADO_VULKAN_SHADER_MODULE_CACHE
+#define AVOCADO_VULKAN_SHADER_MODULE_CACHE
+
+#include "../errorstorage.hpp"
+#include "../utils.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace avocado::vulkan {
+
+// Non-owning view of SPIR-V code. Converts implicitly from the buffers utils::readFile() returns.
+class SpirvView {
+public:
+    SpirvView(const std::vector<char> &code) noexcept;
+    SpirvView(const char *data, const size_t size) noexcept;
+
+    const char *getData() const noexcept;
+    size_t getSize() const noexcept;
+
+private:
+    const char *_data = nullptr;
+    size_t _size = 0;
+};
+
+// Shader modules keyed by the hash of their code, shared by all pipeline builders.
+// A module is created only when a pipeline needs it. With VK_EXT_shader_module_identifier a pipeline
+// which is in the pipeline cache is created from the module identifier, so the module is never created.
+// Modules live as long as the cache.
+class ShaderModuleCache: public core::ErrorStorage {
+public:
+    NON_COPYABLE(ShaderModuleCache);
+    NON_MOVABLE(ShaderModuleCache);
+
+    explicit ShaderModuleCache(VkDevice device);
+    ~ShaderModuleCache();
+
+    // VK_EXT_shader_module_identifier and pipelineCreationCacheControl have to be enabled on the device.
+    void enableModuleIdentifiers() noexcept;
+    bool areModuleIdentifiersEnabled() const noexcept;
+
+    // Returns the hash which refers to the code from now on. The code is copied the first time it is seen.
+    // Error state is updated under the lock on every call.
+    uint64_t addCode(const SpirvView code);
+    // The file is read only the first time.
+    uint64_t addFile(const std::string &filePath);
+    // Thread-safe, so pipelines can be built on worker threads. Creates the module if it doesn't exist yet.
+    VkResult getShaderModule(const uint64_t hash, VkShaderModule &shaderModule);
+    // Returns nullptr if module identifiers are disabled.
+    const VkShaderModuleIdentifierEXT *getModuleIdentifier(const uint64_t hash) const;
+
+    size_t getCodeCount() const;
+
+private:
+    struct Entry {
+        std::vector<char> code;
+        VkShaderModule shaderModule = VK_NULL_HANDLE;
+        VkShaderModuleIdentifierEXT identifier{};
+    };
+
+    VkDevice _device = VK_NULL_HANDLE;
+    PFN_vkGetShaderModuleCreateInfoIdentifierEXT _getModuleIdentifier = nullptr;
+    mutable std::mutex _mutex;
+    // Entries are never erased, so pointers to identifiers stay valid.
+    std::unordered_map<uint64_t, Entry> _entries;
+    std::unordered_map<std::string, uint64_t> _fileHashes;
+};
+
+} // namespace avocado::vulkan.
+
+#endif
@@ -0,0 +1,46 @@
+#include "specializationconstants.hpp"
+
+#include "../utils.hpp"
+
+namespace avocado::vulkan {
+
+bool SpecializationConstants::isEmpty() const noexcept {
+    return _values.empty();
+}
+
+void SpecializationConstants::appendKey(std::string &key) const {
+    utils::appendKeyBytes(key, _values.size());
+    for (const auto &[constantId, value] : _values) {
+        utils::appendKeyBytes(key, constantId);
+        utils::appendKeyBytes(key, value);
+    }
+}
+
+const VkSpecializationInfo *SpecializationConstants::createSpecializationInfo() {
+    if (_values.empty())
+        return nullptr;
+
+    _mapEntries.clear();
+    _data.clear();
+    for (const auto &[constantId, value] : _values) {
+        VkSpecializationMapEntry mapEntry{};
+        mapEntry.constantID = constantId;
+        mapEntry.offset = static_cast<uint32_t>(_data.size());
+        mapEntry.size = value.size();
+        _mapEntries.push_back(mapEntry);
+        _data.insert(_data.end(), value.begin(), value.end());
+    }
+
+    _specializationInfo.mapEntryCount = static_cast<uint32_t>(_mapEntries.size());
+    _specializationInfo.pMapEntries = _mapEntries.data();
+    _specializationInfo.dataSize = _data.size();
+    _specializationInfo.pData = _data.data();
+    return &_specializationInfo;
+}
+
+void SpecializationConstants::setBytes(const uint32_t constantId, const void *data, const size_t size) {
+    const char *bytes = static_cast<const char*>(data);
+    _values[constantId].assign(bytes, bytes + size);
+}
+
+} // namespace avocado::vulkan.
@@ -0,0 +1,47 @@
+#ifndef AVOCADO_VULKAN_SPECIALIZATION_CONSTANTS
+#define AVOCADO_VULKAN_SPECIALIZATION_CONSTANTS
+
+#include <vulkan/vulkan_core.h>
+
+#include <map>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace avocado::vulkan {
+
+// Values of the constant_id constants of one shader stage. The driver compiles them into the shader,
+// so branches and loops which depend on them cost nothing on the GPU.
+class SpecializationConstants {
+public:
+    // Booleans are stored as VkBool32, which is what SPIR-V expects.
+    template <typename T>
+    void set(const uint32_t constantId, const T value) {
+        static_assert(std::is_arithmetic_v<T>, "Specialization constant must be a scalar");
+
+        if constexpr (std::is_same_v<T, bool>) {
+            const VkBool32 boolValue = (value ? VK_TRUE : VK_FALSE);
+            setBytes(constantId, &boolValue, sizeof(boolValue));
+        } else {
+            setBytes(constantId, &value, sizeof(value));
+        }
+    }
+
+    bool isEmpty() const noexcept;
+    // Appends ids and values in id order, so the order of set() calls doesn't matter.
+    void appendKey(std::string &key) const;
+    // Points into this object, valid until a constant is set. Returns nullptr if there are no constants.
+    const VkSpecializationInfo *createSpecializationInfo();
+
+private:
+    void setBytes(const uint32_t constantId, const void *data, const size_t size);
+
+    std::map<uint32_t, std::vector<char>> _values;
+    std::vector<VkSpecializationMapEntry> _mapEntries;
+    std::vector<char> _data;
+    VkSpecializationInfo _specializationInfo{};
+};
+
+} // namespace avocado::vulkan.
+
+#endif
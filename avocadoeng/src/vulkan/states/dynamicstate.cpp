@@ -2,6 +2,8 @@
 
 #include "../vkutils.hpp"
 
+#include <algorithm>
+
 namespace avocado::vulkan {
 
 DynamicState::DynamicState(const std::vector<VkDynamicState> &dynStates):
@@ -28,6 +30,40 @@ void DynamicState::setDynamicStates(std::vector<VkDynamicState> &&dynStates) noe
     _dynamicStates = std::move(dynStates);
 }
 
+void DynamicState::addDynamicStates(const std::vector<VkDynamicState> &dynStates) {
+    for (const VkDynamicState dynState : dynStates) {
+        if (!isDynamic(dynState))
+            _dynamicStates.push_back(dynState);
+    }
+}
+
+bool DynamicState::isDynamic(const VkDynamicState dynState) const noexcept {
+    return std::find(_dynamicStates.begin(), _dynamicStates.end(), dynState) != _dynamicStates.end();
+}
+
+const std::vector<VkDynamicState> &DynamicState::getExtendedDynamicStates() noexcept {
+    static const std::vector<VkDynamicState> dynStates {
+        VK_DYNAMIC_STATE_CULL_MODE,
+        VK_DYNAMIC_STATE_FRONT_FACE,
+        VK_DYNAMIC_STATE_PRIMITIVE_TOPOLOGY,
+        VK_DYNAMIC_STATE_DEPTH_TEST_ENABLE,
+        VK_DYNAMIC_STATE_DEPTH_WRITE_ENABLE,
+        VK_DYNAMIC_STATE_DEPTH_COMPARE_OP,
+        VK_DYNAMIC_STATE_DEPTH_BIAS_ENABLE,
+        VK_DYNAMIC_STATE_RASTERIZER_DISCARD_ENABLE,
+        VK_DYNAMIC_STATE_PRIMITIVE_RESTART_ENABLE
+    };
+    return dynStates;
+}
+
+const std::vector<VkDynamicState> &DynamicState::getExtendedDynamicStates3() noexcept {
+    static const std::vector<VkDynamicState> dynStates {
+        VK_DYNAMIC_STATE_COLOR_BLEND_ENABLE_EXT,
+        VK_DYNAMIC_STATE_POLYGON_MODE_EXT
+    };
+    return dynStates;
+}
+
 VkPipelineDynamicStateCreateInfo DynamicState::createCreateInfo() noexcept {
     VkPipelineDynamicStateCreateInfo dynamicStateCI{}; FILL_S_TYPE(dynamicStateCI);
     dynamicStateCI.dynamicStateCount = getDynamicStateCount();
@@ -17,6 +17,15 @@ public:
     const VkDynamicState* getDynamicStates() noexcept;
     void setDynamicStates(const std::vector<VkDynamicState> &dynStates);
     void setDynamicStates(std::vector<VkDynamicState> &&dynStates) noexcept;
+    // States which are already dynamic are skipped.
+    void addDynamicStates(const std::vector<VkDynamicState> &dynStates);
+    bool isDynamic(const VkDynamicState dynState) const noexcept;
+
+    // Core since Vulkan 1.3. Pipelines which differ only in these states are one pipeline then,
+    // the values are set with CommandBuffer before drawing.
+    static const std::vector<VkDynamicState> &getExtendedDynamicStates() noexcept;
+    // Require VK_EXT_extended_dynamic_state3.
+    static const std::vector<VkDynamicState> &getExtendedDynamicStates3() noexcept;
 
     // todo extract to some template method.
     VkPipelineDynamicStateCreateInfo createCreateInfo() noexcept;
@@ -32,39 +32,66 @@ inline constexpr VkStructureType StructureType = VK_STRUCTURE_TYPE_MAX_ENUM;
 
 DEFINE_STRUCTURE_TYPE(ApplicationInfo, APPLICATION_INFO);
 DEFINE_STRUCTURE_TYPE(BufferCreateInfo, BUFFER_CREATE_INFO);
+DEFINE_STRUCTURE_TYPE(BufferMemoryBarrier, BUFFER_MEMORY_BARRIER);
+DEFINE_STRUCTURE_TYPE(BufferMemoryBarrier2, BUFFER_MEMORY_BARRIER_2);
 DEFINE_STRUCTURE_TYPE(CommandBufferAllocateInfo, COMMAND_BUFFER_ALLOCATE_INFO);
 DEFINE_STRUCTURE_TYPE(CommandBufferBeginInfo, COMMAND_BUFFER_BEGIN_INFO);
+DEFINE_STRUCTURE_TYPE(CommandBufferInheritanceInfo, COMMAND_BUFFER_INHERITANCE_INFO);
+DEFINE_STRUCTURE_TYPE(CommandBufferSubmitInfo, COMMAND_BUFFER_SUBMIT_INFO);
 DEFINE_STRUCTURE_TYPE(CommandPoolCreateInfo, COMMAND_POOL_CREATE_INFO);
+DEFINE_STRUCTURE_TYPE(ComputePipelineCreateInfo, COMPUTE_PIPELINE_CREATE_INFO);
 DEFINE_STRUCTURE_TYPE(DebugUtilsObjectNameInfoEXT, DEBUG_UTILS_OBJECT_NAME_INFO_EXT);
 DEFINE_STRUCTURE_TYPE(DebugUtilsObjectTagInfoEXT, DEBUG_UTILS_OBJECT_TAG_INFO_EXT);
+DEFINE_STRUCTURE_TYPE(DependencyInfo, DEPENDENCY_INFO);
 DEFINE_STRUCTURE_TYPE(DescriptorPoolCreateInfo, DESCRIPTOR_POOL_CREATE_INFO);
 DEFINE_STRUCTURE_TYPE(DescriptorSetAllocateInfo, DESCRIPTOR_SET_ALLOCATE_INFO);
+DEFINE_STRUCTURE_TYPE(DescriptorSetLayoutBindingFlagsCreateInfo, DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO);
 DEFINE_STRUCTURE_TYPE(DescriptorSetLayoutCreateInfo, DESCRIPTOR_SET_LAYOUT_CREATE_INFO);
+DEFINE_STRUCTURE_TYPE(DescriptorUpdateTemplateCreateInfo, DESCRIPTOR_UPDATE_TEMPLATE_CREATE_INFO);
 DEFINE_STRUCTURE_TYPE(DeviceCreateInfo, DEVICE_CREATE_INFO);
 DEFINE_STRUCTURE_TYPE(DeviceQueueCreateInfo, DEVICE_QUEUE_CREATE_INFO);
 DEFINE_STRUCTURE_TYPE(FenceCreateInfo, FENCE_CREATE_INFO);
 DEFINE_STRUCTURE_TYPE(FramebufferCreateInfo, FRAMEBUFFER_CREATE_INFO);
 DEFINE_STRUCTURE_TYPE(GraphicsPipelineCreateInfo, GRAPHICS_PIPELINE_CREATE_INFO);
+DEFINE_STRUCTURE_TYPE(GraphicsPipelineLibraryCreateInfoEXT, GRAPHICS_PIPELINE_LIBRARY_CREATE_INFO_EXT);
 DEFINE_STRUCTURE_TYPE(ImageCreateInfo, IMAGE_CREATE_INFO);
+DEFINE_STRUCTURE_TYPE(ImageMemoryBarrier, IMAGE_MEMORY_BARRIER);
+DEFINE_STRUCTURE_TYPE(ImageMemoryBarrier2, IMAGE_MEMORY_BARRIER_2);
 DEFINE_STRUCTURE_TYPE(ImageViewCreateInfo, IMAGE_VIEW_CREATE_INFO);
 DEFINE_STRUCTURE_TYPE(InstanceCreateInfo, INSTANCE_CREATE_INFO);
 DEFINE_STRUCTURE_TYPE(MemoryAllocateInfo, MEMORY_ALLOCATE_INFO);
+DEFINE_STRUCTURE_TYPE(PhysicalDeviceExtendedDynamicState3FeaturesEXT, PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_3_FEATURES_EXT);
+DEFINE_STRUCTURE_TYPE(PhysicalDeviceFeatures2, PHYSICAL_DEVICE_FEATURES_2);
+DEFINE_STRUCTURE_TYPE(PhysicalDeviceGraphicsPipelineLibraryFeaturesEXT, PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_FEATURES_EXT);
+DEFINE_STRUCTURE_TYPE(PhysicalDeviceShaderModuleIdentifierFeaturesEXT, PHYSICAL_DEVICE_SHADER_MODULE_IDENTIFIER_FEATURES_EXT);
+DEFINE_STRUCTURE_TYPE(PhysicalDeviceVulkan11Features, PHYSICAL_DEVICE_VULKAN_1_1_FEATURES);
+DEFINE_STRUCTURE_TYPE(PhysicalDeviceVulkan12Features, PHYSICAL_DEVICE_VULKAN_1_2_FEATURES);
+DEFINE_STRUCTURE_TYPE(PhysicalDeviceVulkan13Features, PHYSICAL_DEVICE_VULKAN_1_3_FEATURES);
 DEFINE_STRUCTURE_TYPE(PipelineColorBlendStateCreateInfo, PIPELINE_COLOR_BLEND_STATE_CREATE_INFO);
 DEFINE_STRUCTURE_TYPE(PipelineDynamicStateCreateInfo, PIPELINE_DYNAMIC_STATE_CREATE_INFO);
 DEFINE_STRUCTURE_TYPE(PipelineInputAssemblyStateCreateInfo, PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO);
 DEFINE_STRUCTURE_TYPE(PipelineLayoutCreateInfo, PIPELINE_LAYOUT_CREATE_INFO);
+DEFINE_STRUCTURE_TYPE(PipelineLibraryCreateInfoKHR, PIPELINE_LIBRARY_CREATE_INFO_KHR);
 DEFINE_STRUCTURE_TYPE(PipelineMultisampleStateCreateInfo, PIPELINE_MULTISAMPLE_STATE_CREATE_INFO);
 DEFINE_STRUCTURE_TYPE(PipelineRasterizationStateCreateInfo, PIPELINE_RASTERIZATION_STATE_CREATE_INFO);
 DEFINE_STRUCTURE_TYPE(PipelineShaderStageCreateInfo, PIPELINE_SHADER_STAGE_CREATE_INFO);
+DEFINE_STRUCTURE_TYPE(PipelineShaderStageModuleIdentifierCreateInfoEXT, PIPELINE_SHADER_STAGE_MODULE_IDENTIFIER_CREATE_INFO_EXT);
 DEFINE_STRUCTURE_TYPE(PipelineVertexInputStateCreateInfo, PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO);
 DEFINE_STRUCTURE_TYPE(PipelineViewportStateCreateInfo, PIPELINE_VIEWPORT_STATE_CREATE_INFO);
 DEFINE_STRUCTURE_TYPE(PresentInfoKHR, PRESENT_INFO_KHR);
 DEFINE_STRUCTURE_TYPE(RenderPassBeginInfo, RENDER_PASS_BEGIN_INFO);
 DEFINE_STRUCTURE_TYPE(RenderPassCreateInfo, RENDER_PASS_CREATE_INFO);
+DEFINE_STRUCTURE_TYPE(SamplerCreateInfo, SAMPLER_CREATE_INFO);
 DEFINE_STRUCTURE_TYPE(SemaphoreCreateInfo, SEMAPHORE_CREATE_INFO);
+DEFINE_STRUCTURE_TYPE(SemaphoreSubmitInfo, SEMAPHORE_SUBMIT_INFO);
+DEFINE_STRUCTURE_TYPE(SemaphoreTypeCreateInfo, SEMAPHORE_TYPE_CREATE_INFO);
+DEFINE_STRUCTURE_TYPE(SemaphoreWaitInfo, SEMAPHORE_WAIT_INFO);
 DEFINE_STRUCTURE_TYPE(ShaderModuleCreateInfo, SHADER_MODULE_CREATE_INFO);
+DEFINE_STRUCTURE_TYPE(ShaderModuleIdentifierEXT, SHADER_MODULE_IDENTIFIER_EXT);
 DEFINE_STRUCTURE_TYPE(SwapchainCreateInfoKHR, SWAPCHAIN_CREATE_INFO_KHR);
 DEFINE_STRUCTURE_TYPE(SubmitInfo, SUBMIT_INFO);
+DEFINE_STRUCTURE_TYPE(SubmitInfo2, SUBMIT_INFO_2);
+DEFINE_STRUCTURE_TYPE(TimelineSemaphoreSubmitInfo, TIMELINE_SEMAPHORE_SUBMIT_INFO);
 DEFINE_STRUCTURE_TYPE(WriteDescriptorSet, WRITE_DESCRIPTOR_SET);
 
 }
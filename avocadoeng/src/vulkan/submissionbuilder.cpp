@@ -0,0 +1,69 @@
+#include "submissionbuilder.hpp"
+
+#include "vkutils.hpp"
+
+namespace avocado::vulkan {
+
+namespace {
+
+VkSemaphoreSubmitInfo createSemaphoreSubmitInfo(VkSemaphore semaphore, const VkPipelineStageFlags2 stages, const uint64_t value) noexcept {
+    VkSemaphoreSubmitInfo semaphoreInfo{}; FILL_S_TYPE(semaphoreInfo);
+    semaphoreInfo.semaphore = semaphore;
+    semaphoreInfo.value = value;
+    semaphoreInfo.stageMask = stages;
+    return semaphoreInfo;
+}
+
+} // namespace.
+
+void SubmissionBuilder::nextBatch() {
+    _batches.emplace_back();
+}
+
+void SubmissionBuilder::addCommandBuffer(VkCommandBuffer commandBuffer) {
+    VkCommandBufferSubmitInfo commandBufferInfo{}; FILL_S_TYPE(commandBufferInfo);
+    commandBufferInfo.commandBuffer = commandBuffer;
+    getCurrentBatch().commandBuffers.push_back(commandBufferInfo);
+}
+
+void SubmissionBuilder::addWaitSemaphore(VkSemaphore semaphore, const VkPipelineStageFlags2 stages, const uint64_t value) {
+    getCurrentBatch().waitSemaphores.push_back(createSemaphoreSubmitInfo(semaphore, stages, value));
+}
+
+void SubmissionBuilder::addSignalSemaphore(VkSemaphore semaphore, const VkPipelineStageFlags2 stages, const uint64_t value) {
+    getCurrentBatch().signalSemaphores.push_back(createSemaphoreSubmitInfo(semaphore, stages, value));
+}
+
+bool SubmissionBuilder::isEmpty() const noexcept {
+    return _batches.empty();
+}
+
+void SubmissionBuilder::clear() noexcept {
+    _batches.clear();
+}
+
+std::vector<VkSubmitInfo2> SubmissionBuilder::createSubmitInfos() const {
+    std::vector<VkSubmitInfo2> submitInfos;
+    submitInfos.reserve(_batches.size());
+    for (const Batch &batch : _batches) {
+        VkSubmitInfo2 submitInfo{}; FILL_S_TYPE(submitInfo);
+        submitInfo.waitSemaphoreInfoCount = static_cast<uint32_t>(batch.waitSemaphores.size());
+        submitInfo.pWaitSemaphoreInfos = batch.waitSemaphores.data();
+        submitInfo.commandBufferInfoCount = static_cast<uint32_t>(batch.commandBuffers.size());
+        submitInfo.pCommandBufferInfos = batch.commandBuffers.data();
+        submitInfo.signalSemaphoreInfoCount = static_cast<uint32_t>(batch.signalSemaphores.size());
+        submitInfo.pSignalSemaphoreInfos = batch.signalSemaphores.data();
+        submitInfos.push_back(submitInfo);
+    }
+
+    return submitInfos;
+}
+
+SubmissionBuilder::Batch &SubmissionBuilder::getCurrentBatch() {
+    if (_batches.empty())
+        nextBatch();
+
+    return _batches.back();
+}
+
+} // namespace avocado::vulkan.
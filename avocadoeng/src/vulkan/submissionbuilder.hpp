@@ -0,0 +1,39 @@
+#ifndef AVOCADO_VULKAN_SUBMISSION_BUILDER
+#define AVOCADO_VULKAN_SUBMISSION_BUILDER
+
+#include <vulkan/vulkan_core.h>
+
+#include <vector>
+
+namespace avocado::vulkan {
+
+// Accumulates several submit batches, so Queue::submit() flushes all of them with one
+// vkQueueSubmit2 call. Semaphore values are only used for timeline semaphores.
+class SubmissionBuilder {
+public:
+    // Starts a new batch. Commands and semaphores are added to the last batch.
+    void nextBatch();
+    void addCommandBuffer(VkCommandBuffer commandBuffer);
+    void addWaitSemaphore(VkSemaphore semaphore, const VkPipelineStageFlags2 stages, const uint64_t value = 0);
+    void addSignalSemaphore(VkSemaphore semaphore, const VkPipelineStageFlags2 stages, const uint64_t value = 0);
+
+    bool isEmpty() const noexcept;
+    void clear() noexcept;
+    // Pointers stay valid until the builder is modified.
+    std::vector<VkSubmitInfo2> createSubmitInfos() const;
+
+private:
+    struct Batch {
+        std::vector<VkSemaphoreSubmitInfo> waitSemaphores;
+        std::vector<VkCommandBufferSubmitInfo> commandBuffers;
+        std::vector<VkSemaphoreSubmitInfo> signalSemaphores;
+    };
+
+    Batch &getCurrentBatch();
+
+    std::vector<Batch> _batches;
+};
+
+} // namespace avocado::vulkan.
+
+#endif
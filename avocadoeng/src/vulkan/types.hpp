@@ -8,6 +8,18 @@ namespace avocado::vulkan {
 // Queue family in Vulkan API is used as index.
 using QueueFamily = uint32_t;
 
+// How an allocation is accessed, the memory type is chosen for it.
+enum class MemoryUsage {
+    // Only the GPU reads and writes it, e.g. sampled images and buffers filled by transfers.
+    GpuOnly,
+    // Written once by the CPU and read by a transfer, e.g. staging buffers.
+    Upload,
+    // Written by the GPU and read by the CPU.
+    Readback,
+    // Written by the CPU and read by shaders every frame, e.g. uniform buffers.
+    DynamicPerFrame
+};
+
 }
 
 #endif
@@ -0,0 +1,317 @@
+#include "uploadbatch.hpp"
+
+#include "image.hpp"
+#include "logicaldevice.hpp"
+#include "queue.hpp"
+#include "vkutils.hpp"
+
+using namespace std::string_literals;
+
+namespace avocado::vulkan {
+
+namespace {
+
+// Usage of the commands which follow a transition to the layout.
+bool getLayoutUsage(const VkImageLayout layout, ResourceUsage &usage) noexcept {
+    usage.layout = layout;
+    switch (layout) {
+        case VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL:
+            usage.stages = VK_PIPELINE_STAGE_2_TRANSFER_BIT;
+            usage.access = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+            return true;
+        case VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL:
+            usage.stages = VK_PIPELINE_STAGE_2_TRANSFER_BIT;
+            usage.access = VK_ACCESS_2_TRANSFER_READ_BIT;
+            return true;
+        case VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL:
+            usage.stages = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT;
+            usage.access = VK_ACCESS_2_SHADER_READ_BIT;
+            return true;
+        case VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL:
+            usage.stages = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT;
+            usage.access = VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT;
+            return true;
+        default:
+            return false;
+    }
+}
+
+} // namespace.
+
+UploadBatch::UploadBatch(LogicalDevice &device, VkCommandPool commandPool):
+    _device(device),
+    _commandPool(commandPool) {
+    std::vector<CommandBuffer> commandBuffers = _device.allocateCommandBuffers(1, _commandPool, VK_COMMAND_BUFFER_LEVEL_PRIMARY);
+    setHasError(_device.hasError());
+    if (hasError()) {
+        setErrorMessage("Can't allocate command buffer: "s + _device.getErrorMessage());
+        return;
+    }
+    _commandBuffer = commandBuffers.front();
+
+    FencePool &fencePool = _device.getFencePool();
+    _fence = fencePool.acquire();
+    setHasError(fencePool.hasError());
+    if (hasError())
+        setErrorMessage("Can't acquire fence: "s + fencePool.getErrorMessage());
+}
+
+UploadBatch::~UploadBatch() {
+    // The command buffer and staging buffers can't be released while the GPU still uses them.
+    if (_isSubmitted)
+        wait();
+
+    if (_commandBuffer.isValid()) {
+        VkCommandBuffer handle = _commandBuffer.getHandle();
+        vkFreeCommandBuffers(_device.getHandle(), _commandPool, 1, &handle);
+    }
+
+    _device.getFencePool().release(_fence, _isSubmitted);
+}
+
+void UploadBatch::transitionImageLayout(Image &image, const VkImageLayout oldLayout, const VkImageLayout newLayout) {
+    assert(!_isSubmitted);
+
+    ResourceUsage usage;
+    setHasError(!getLayoutUsage(newLayout, usage));
+    if (hasError()) {
+        setErrorMessage("Unsupported layout transition");
+        return;
+    }
+
+    beginIfNeeded();
+    if (hasError())
+        return;
+
+    // Transitions of different images are merged into one vkCmdPipelineBarrier2 call,
+    // a second transition of the same image has to be ordered after the first one.
+    trackImage(image, oldLayout);
+    if (_stateTracker.hasPendingBarriers(image.getHandle()))
+        _stateTracker.flushBarriers(_commandBuffer);
+
+    _stateTracker.useImage(image.getHandle(), usage);
+}
+
+void UploadBatch::copyBufferToImage(Buffer &buffer, Image &image, const uint32_t width, const uint32_t height) {
+    assert(!_isSubmitted);
+
+    beginIfNeeded();
+    if (hasError())
+        return;
+
+    // Images the batch sees first time are overwritten, so their old content is discarded.
+    trackBuffer(buffer);
+    trackImage(image, VK_IMAGE_LAYOUT_UNDEFINED);
+    if (_stateTracker.hasPendingBarriers(image.getHandle()))
+        _stateTracker.flushBarriers(_commandBuffer);
+
+    VkImageSubresourceRange range{};
+    range.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    range.levelCount = 1;
+    range.layerCount = 1;
+    _stateTracker.useBuffer(buffer.getHandle(), {VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_READ_BIT});
+    _stateTracker.useImage(image.getHandle(), {VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT,
+        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL}, range);
+    _stateTracker.flushBarriers(_commandBuffer);
+    buffer.copyToImage(image, width, height, _commandBuffer);
+}
+
+void UploadBatch::copyBuffer(Buffer &srcBuffer, Buffer &dstBuffer, const std::vector<VkBufferCopy> &regions) {
+    assert(!_isSubmitted);
+
+    beginIfNeeded();
+    if (hasError())
+        return;
+
+    // Only the copied ranges are synchronized, copies into other parts of the buffer don't wait.
+    trackBuffer(srcBuffer);
+    trackBuffer(dstBuffer);
+    for (const VkBufferCopy &region : regions) {
+        _stateTracker.useBuffer(srcBuffer.getHandle(), {VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_READ_BIT},
+            region.srcOffset, region.size);
+        _stateTracker.useBuffer(dstBuffer.getHandle(), {VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT},
+            region.dstOffset, region.size);
+    }
+
+    _stateTracker.flushBarriers(_commandBuffer);
+    _commandBuffer.copyBuffer(srcBuffer, dstBuffer, regions);
+}
+
+void UploadBatch::releaseImage(Image &image, const VkImageLayout oldLayout, const VkImageLayout newLayout,
+    const QueueFamily srcQueueFamily, const QueueFamily dstQueueFamily) {
+    if (srcQueueFamily == dstQueueFamily) {
+        transitionImageLayout(image, oldLayout, newLayout);
+        return;
+    }
+
+    assert(!_isSubmitted);
+
+    ResourceUsage usage;
+    setHasError(!getLayoutUsage(newLayout, usage));
+    if (hasError()) {
+        setErrorMessage("Unsupported layout transition");
+        return;
+    }
+
+    beginIfNeeded();
+    if (hasError())
+        return;
+
+    trackImage(image, oldLayout);
+
+    // Both halves must describe the same transition. Access masks of the other queue are ignored.
+    VkImageMemoryBarrier2 acquireBarrier{}; FILL_S_TYPE(acquireBarrier);
+    acquireBarrier.dstAccessMask = usage.access;
+    acquireBarrier.oldLayout = _stateTracker.getImageLayout(image.getHandle());
+    acquireBarrier.newLayout = newLayout;
+    acquireBarrier.srcQueueFamilyIndex = srcQueueFamily;
+    acquireBarrier.dstQueueFamilyIndex = dstQueueFamily;
+    acquireBarrier.image = image.getHandle();
+    acquireBarrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    acquireBarrier.subresourceRange.levelCount = VK_REMAINING_MIP_LEVELS;
+    acquireBarrier.subresourceRange.layerCount = VK_REMAINING_ARRAY_LAYERS;
+    _acquireImageBarriers.push_back(acquireBarrier);
+
+    if (_stateTracker.hasPendingBarriers(image.getHandle()))
+        _stateTracker.flushBarriers(_commandBuffer);
+    _stateTracker.releaseImage(image.getHandle(), newLayout, srcQueueFamily, dstQueueFamily);
+}
+
+void UploadBatch::releaseBuffer(Buffer &buffer, const VkAccessFlags2 dstAccess, const VkPipelineStageFlags2 dstStages,
+    const QueueFamily srcQueueFamily, const QueueFamily dstQueueFamily) {
+    assert(!_isSubmitted);
+
+    beginIfNeeded();
+    if (hasError())
+        return;
+
+    trackBuffer(buffer);
+    if (srcQueueFamily == dstQueueFamily) {
+        _stateTracker.useBuffer(buffer.getHandle(), {dstStages, dstAccess});
+        return;
+    }
+
+    VkBufferMemoryBarrier2 acquireBarrier{}; FILL_S_TYPE(acquireBarrier);
+    acquireBarrier.dstAccessMask = dstAccess;
+    acquireBarrier.srcQueueFamilyIndex = srcQueueFamily;
+    acquireBarrier.dstQueueFamilyIndex = dstQueueFamily;
+    acquireBarrier.buffer = buffer.getHandle();
+    acquireBarrier.offset = 0;
+    acquireBarrier.size = VK_WHOLE_SIZE;
+    _acquireBufferBarriers.push_back(acquireBarrier);
+
+    _stateTracker.releaseBuffer(buffer.getHandle(), srcQueueFamily, dstQueueFamily);
+}
+
+void UploadBatch::recordAcquireBarriers(CommandBuffer &commandBuffer, const VkPipelineStageFlags2 dstStages) const noexcept {
+    if (!hasAcquireBarriers())
+        return;
+
+    std::vector<VkBufferMemoryBarrier2> bufferBarriers = _acquireBufferBarriers;
+    for (VkBufferMemoryBarrier2 &barrier : bufferBarriers) {
+        barrier.srcStageMask = dstStages;
+        barrier.dstStageMask = dstStages;
+    }
+
+    std::vector<VkImageMemoryBarrier2> imageBarriers = _acquireImageBarriers;
+    for (VkImageMemoryBarrier2 &barrier : imageBarriers) {
+        barrier.srcStageMask = dstStages;
+        barrier.dstStageMask = dstStages;
+    }
+
+    commandBuffer.pipelineBarrier2(bufferBarriers, imageBarriers);
+}
+
+bool UploadBatch::hasAcquireBarriers() const noexcept {
+    return (!_acquireBufferBarriers.empty() || !_acquireImageBarriers.empty());
+}
+
+void UploadBatch::addStagingBuffer(Buffer &&buffer) {
+    _stagingBuffers.emplace_back(std::move(buffer));
+}
+
+void UploadBatch::submit(Queue &queue, VkSemaphore signalSemaphore) {
+    assert(!_isSubmitted);
+
+    if (!_isRecording)
+        return;
+
+    _stateTracker.flushBarriers(_commandBuffer);
+    _commandBuffer.end();
+    _isRecording = false;
+    setHasError(_commandBuffer.hasError());
+    if (hasError()) {
+        setErrorMessage("Can't end command buffer: "s + _commandBuffer.getErrorMessage());
+        return;
+    }
+
+    VkCommandBuffer commandBufferHandle = _commandBuffer.getHandle();
+    VkSubmitInfo submitInfo{}; FILL_S_TYPE(submitInfo);
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &commandBufferHandle;
+    if (signalSemaphore != VK_NULL_HANDLE) {
+        submitInfo.signalSemaphoreCount = 1;
+        submitInfo.pSignalSemaphores = &signalSemaphore;
+    }
+
+    queue.submit(submitInfo, _fence);
+    setHasError(queue.hasError());
+    if (hasError()) {
+        setErrorMessage("Can't submit upload batch: "s + queue.getErrorMessage());
+        return;
+    }
+
+    _isSubmitted = true;
+}
+
+bool UploadBatch::isSubmitted() const noexcept {
+    return _isSubmitted;
+}
+
+bool UploadBatch::isComplete() noexcept {
+    if (!_isSubmitted)
+        return false;
+
+    const VkResult result = vkGetFenceStatus(_device.getHandle(), _fence);
+    setHasError(result != VK_SUCCESS && result != VK_NOT_READY);
+    if (hasError())
+        setErrorMessage("vkGetFenceStatus returned "s + getVkResultString(result));
+
+    return (result == VK_SUCCESS);
+}
+
+void UploadBatch::wait(const uint64_t timeout) noexcept {
+    if (!_isSubmitted)
+        return;
+
+    _device.waitForFences({_fence}, true, timeout);
+    setHasError(_device.hasError());
+    if (hasError())
+        setErrorMessage("Can't wait for upload batch: "s + _device.getErrorMessage());
+}
+
+void UploadBatch::beginIfNeeded() {
+    if (_isRecording)
+        return;
+
+    _commandBuffer.begin(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+    setHasError(_commandBuffer.hasError());
+    if (hasError()) {
+        setErrorMessage("Can't begin command buffer: "s + _commandBuffer.getErrorMessage());
+        return;
+    }
+
+    _isRecording = true;
+}
+
+void UploadBatch::trackImage(Image &image, const VkImageLayout layout) {
+    if (!_stateTracker.isImageRegistered(image.getHandle()))
+        _stateTracker.registerImage(image.getHandle(), VK_IMAGE_ASPECT_COLOR_BIT, image.getMipLevels(), image.getArrayLayerCount(), layout);
+}
+
+void UploadBatch::trackBuffer(Buffer &buffer) {
+    if (!_stateTracker.isBufferRegistered(buffer.getHandle()))
+        _stateTracker.registerBuffer(buffer.getHandle(), buffer.getSize());
+}
+
+} // namespace avocado::vulkan.
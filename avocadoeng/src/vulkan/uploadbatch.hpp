@@ -0,0 +1,79 @@
+#ifndef AVOCADO_VULKAN_UPLOAD_BATCH
+#define AVOCADO_VULKAN_UPLOAD_BATCH
+
+#include "buffer.hpp"
+#include "commandbuffer.hpp"
+#include "resourcestatetracker.hpp"
+#include "types.hpp"
+
+#include "../errorstorage.hpp"
+#include "../utils.hpp"
+
+#include <vulkan/vulkan_core.h>
+
+#include <limits>
+#include <vector>
+
+namespace avocado::vulkan {
+
+class Image;
+class LogicalDevice;
+class Queue;
+
+// Records many one-shot transfer operations (layout transitions, copies) into a single
+// command buffer and submits them at once. Completion is tracked with a fence,
+// so callers can poll or wait instead of idling the queue after every operation.
+// Barriers come from a resource state tracker, the old layout is only used for images the batch sees first time.
+class UploadBatch: public core::ErrorStorage {
+public:
+    NON_COPYABLE(UploadBatch);
+    NON_MOVABLE(UploadBatch);
+
+    explicit UploadBatch(LogicalDevice &device, VkCommandPool commandPool);
+    ~UploadBatch();
+
+    // The new layout can't be VK_IMAGE_LAYOUT_UNDEFINED.
+    void transitionImageLayout(Image &image, const VkImageLayout oldLayout, const VkImageLayout newLayout);
+    // Transitions the image to VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL itself.
+    void copyBufferToImage(Buffer &buffer, Image &image, const uint32_t width, const uint32_t height);
+    void copyBuffer(Buffer &srcBuffer, Buffer &dstBuffer, const std::vector<VkBufferCopy> &regions);
+
+    // Queue family ownership transfer. The release half is recorded into this batch, the acquire half
+    // has to be recorded on the destination queue with recordAcquireBarriers() after it waits for the
+    // semaphore signaled by submit(). With equal families these are ordinary barriers.
+    void releaseImage(Image &image, const VkImageLayout oldLayout, const VkImageLayout newLayout,
+        const QueueFamily srcQueueFamily, const QueueFamily dstQueueFamily);
+    void releaseBuffer(Buffer &buffer, const VkAccessFlags2 dstAccess, const VkPipelineStageFlags2 dstStages,
+        const QueueFamily srcQueueFamily, const QueueFamily dstQueueFamily);
+    // Source stages are the same as the destination ones, they have to match the semaphore wait stages.
+    void recordAcquireBarriers(CommandBuffer &commandBuffer, const VkPipelineStageFlags2 dstStages) const noexcept;
+    bool hasAcquireBarriers() const noexcept;
+
+    // Keeps the staging buffer alive until the batch is destroyed.
+    void addStagingBuffer(Buffer &&buffer);
+
+    void submit(Queue &queue, VkSemaphore signalSemaphore = VK_NULL_HANDLE);
+    bool isSubmitted() const noexcept;
+    bool isComplete() noexcept;
+    void wait(const uint64_t timeout = std::numeric_limits<uint64_t>::max()) noexcept;
+
+private:
+    void beginIfNeeded();
+    void trackImage(Image &image, const VkImageLayout layout);
+    void trackBuffer(Buffer &buffer);
+
+    LogicalDevice &_device;
+    VkCommandPool _commandPool = VK_NULL_HANDLE;
+    CommandBuffer _commandBuffer;
+    VkFence _fence = VK_NULL_HANDLE;
+    ResourceStateTracker _stateTracker;
+    std::vector<VkBufferMemoryBarrier2> _acquireBufferBarriers;
+    std::vector<VkImageMemoryBarrier2> _acquireImageBarriers;
+    std::vector<Buffer> _stagingBuffers;
+    bool _isRecording = false;
+    bool _isSubmitted = false;
+};
+
+} // namespace avocado::vulkan.
+
+#endif
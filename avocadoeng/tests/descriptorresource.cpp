@@ -0,0 +1,75 @@
+#include "../src/vulkan/descriptorresource.hpp"
+
+#include <catch_amalgamated.hpp>
+
+#include <cstdint>
+#include <vector>
+
+using namespace avocado::vulkan;
+
+namespace {
+
+// Keys never dereference handles.
+template <typename T>
+T makeHandle(const uintptr_t value) {
+    return reinterpret_cast<T>(value);
+}
+
+const VkDescriptorSetLayout layout = makeHandle<VkDescriptorSetLayout>(0x10);
+
+DescriptorResource createUniformBuffer(const uint32_t binding, const uintptr_t buffer) {
+    return DescriptorResource::createBuffer(binding, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, makeHandle<VkBuffer>(buffer));
+}
+
+DescriptorResource createTexture(const uint32_t binding, const uintptr_t imageView) {
+    return DescriptorResource::createImage(binding, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+        makeHandle<VkImageView>(imageView), makeHandle<VkSampler>(0x30));
+}
+
+std::string createNormalizedKey(std::vector<DescriptorResource> resources) {
+    DescriptorResource::normalize(resources);
+    return DescriptorResource::createContentsKey(layout, resources);
+}
+
+} // namespace.
+
+TEST_CASE("Descriptor resource keys", "[vulkan]") {
+    SECTION("The order of resources doesn't change the key") {
+        REQUIRE(createNormalizedKey({createUniformBuffer(0, 0x100), createTexture(1, 0x200)}) ==
+            createNormalizedKey({createTexture(1, 0x200), createUniformBuffer(0, 0x100)}));
+    }
+
+    SECTION("Array elements are ordered within a binding") {
+        DescriptorResource second = createTexture(1, 0x201);
+        second.arrayElement = 1;
+        std::vector<DescriptorResource> resources{second, createTexture(1, 0x200), createUniformBuffer(0, 0x100)};
+        DescriptorResource::normalize(resources);
+
+        REQUIRE(resources.size() == 3);
+        REQUIRE(resources[0].binding == 0);
+        REQUIRE(resources[1].arrayElement == 0);
+        REQUIRE(resources[2].arrayElement == 1);
+    }
+
+    SECTION("The last of duplicated elements is kept") {
+        std::vector<DescriptorResource> resources{createTexture(1, 0x200), createUniformBuffer(0, 0x100), createTexture(1, 0x201)};
+        DescriptorResource::normalize(resources);
+
+        REQUIRE(resources.size() == 2);
+        REQUIRE(resources[1].imageView == makeHandle<VkImageView>(0x201));
+    }
+
+    SECTION("Contents keys differ by resources, slots keys only by written elements") {
+        std::vector<DescriptorResource> first{createUniformBuffer(0, 0x100), createTexture(1, 0x200)};
+        std::vector<DescriptorResource> second{createUniformBuffer(0, 0x101), createTexture(1, 0x200)};
+        REQUIRE(DescriptorResource::createContentsKey(layout, first) != DescriptorResource::createContentsKey(layout, second));
+        REQUIRE(DescriptorResource::createSlotsKey(layout, first) == DescriptorResource::createSlotsKey(layout, second));
+
+        // A set written without binding 1 would keep the texture of the previous contents.
+        const std::vector<DescriptorResource> partial{createUniformBuffer(0, 0x100)};
+        REQUIRE(DescriptorResource::createSlotsKey(layout, first) != DescriptorResource::createSlotsKey(layout, partial));
+
+        const VkDescriptorSetLayout otherLayout = makeHandle<VkDescriptorSetLayout>(0x11);
+        REQUIRE(DescriptorResource::createSlotsKey(layout, first) != DescriptorResource::createSlotsKey(otherLayout, first));
+    }
+}
@@ -0,0 +1,54 @@
+#include "../src/indexallocator.hpp"
+
+#include <catch_amalgamated.hpp>
+
+using namespace avocado::core;
+
+TEST_CASE("Index allocator", "[core]") {
+    SECTION("Indices are handed out in order up to the capacity") {
+        IndexAllocator allocator(3);
+        REQUIRE(allocator.getCapacity() == 3);
+        REQUIRE(allocator.allocate() == 0);
+        REQUIRE(allocator.allocate() == 1);
+        REQUIRE(allocator.allocate() == 2);
+        REQUIRE(allocator.allocate() == IndexAllocator::invalidIndex);
+        REQUIRE(allocator.getUsedCount() == 3);
+    }
+
+    SECTION("Freed indices are reused first") {
+        IndexAllocator allocator(4);
+        for (int i = 0; i < 3; ++i)
+            allocator.allocate();
+
+        allocator.free(1);
+        REQUIRE(allocator.getUsedCount() == 2);
+        REQUIRE(allocator.allocate() == 1);
+        REQUIRE(allocator.allocate() == 3);
+        REQUIRE(allocator.getUsedCount() == 4);
+    }
+
+    SECTION("A full allocator accepts indices again after a free") {
+        IndexAllocator allocator(1);
+        REQUIRE(allocator.allocate() == 0);
+        REQUIRE(allocator.allocate() == IndexAllocator::invalidIndex);
+        allocator.free(0);
+        REQUIRE(allocator.allocate() == 0);
+    }
+
+    SECTION("Double frees and unallocated indices are rejected") {
+        IndexAllocator allocator(4);
+        allocator.allocate();
+        allocator.allocate();
+
+        REQUIRE(allocator.free(1));
+        REQUIRE_FALSE(allocator.free(1));
+        REQUIRE_FALSE(allocator.free(2));
+        REQUIRE_FALSE(allocator.free(IndexAllocator::invalidIndex));
+        REQUIRE(allocator.getUsedCount() == 1);
+
+        // The rejected frees didn't put the index on the free list twice.
+        REQUIRE(allocator.allocate() == 1);
+        REQUIRE(allocator.allocate() == 2);
+        REQUIRE(allocator.free(1));
+    }
+}
@@ -0,0 +1,148 @@
+#include "../src/vulkan/resourcestatetracker.hpp"
+
+#include <catch_amalgamated.hpp>
+
+#include <cstdint>
+
+using namespace avocado::vulkan;
+
+namespace {
+
+// The tracker never dereferences handles.
+const VkImage image = reinterpret_cast<VkImage>(uintptr_t(0x10));
+const VkBuffer buffer = reinterpret_cast<VkBuffer>(uintptr_t(0x20));
+
+const ResourceUsage transferWrite{VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT,
+    VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL};
+const ResourceUsage fragmentRead{VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT, VK_ACCESS_2_SHADER_READ_BIT,
+    VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
+const ResourceUsage vertexRead{VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT, VK_ACCESS_2_SHADER_READ_BIT,
+    VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
+
+} // namespace.
+
+TEST_CASE("Resource state tracker images", "[vulkan]") {
+    ResourceStateTracker tracker;
+    tracker.registerImage(image, VK_IMAGE_ASPECT_COLOR_BIT, 3, 1);
+
+    SECTION("The first use transitions from the registered layout") {
+        tracker.useImage(image, transferWrite);
+        REQUIRE(tracker.hasPendingBarriers(image));
+
+        // All mip levels have the same transition, so they share one barrier.
+        const std::vector<VkImageMemoryBarrier2> &barriers = tracker.getPendingImageBarriers();
+        REQUIRE(barriers.size() == 1);
+        REQUIRE(barriers[0].srcStageMask == VK_PIPELINE_STAGE_2_NONE);
+        REQUIRE(barriers[0].dstStageMask == VK_PIPELINE_STAGE_2_TRANSFER_BIT);
+        REQUIRE(barriers[0].dstAccessMask == VK_ACCESS_2_TRANSFER_WRITE_BIT);
+        REQUIRE(barriers[0].oldLayout == VK_IMAGE_LAYOUT_UNDEFINED);
+        REQUIRE(barriers[0].newLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+        REQUIRE(barriers[0].subresourceRange.baseMipLevel == 0);
+        REQUIRE(barriers[0].subresourceRange.levelCount == 3);
+        REQUIRE(tracker.getImageLayout(image, 2) == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+    }
+
+    SECTION("Reading a write waits for it, reads of visible data need no barrier") {
+        tracker.useImage(image, transferWrite);
+        tracker.clearPendingBarriers();
+
+        tracker.useImage(image, fragmentRead);
+        const std::vector<VkImageMemoryBarrier2> &barriers = tracker.getPendingImageBarriers();
+        REQUIRE(barriers.size() == 1);
+        REQUIRE(barriers[0].srcStageMask == VK_PIPELINE_STAGE_2_TRANSFER_BIT);
+        REQUIRE(barriers[0].srcAccessMask == VK_ACCESS_2_TRANSFER_WRITE_BIT);
+        REQUIRE(barriers[0].oldLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+        REQUIRE(barriers[0].newLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+        tracker.clearPendingBarriers();
+
+        tracker.useImage(image, fragmentRead);
+        REQUIRE_FALSE(tracker.hasPendingBarriers());
+
+        // Another stage hasn't seen the write yet.
+        tracker.useImage(image, vertexRead);
+        REQUIRE(tracker.getPendingImageBarriers().size() == 1);
+        REQUIRE(tracker.getPendingImageBarriers()[0].oldLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    }
+
+    SECTION("Subresources are tracked separately") {
+        VkImageSubresourceRange range{};
+        range.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        range.baseMipLevel = 1;
+        range.levelCount = 1;
+        range.layerCount = 1;
+        tracker.useImage(image, transferWrite, range);
+        REQUIRE(tracker.getImageLayout(image, 0) == VK_IMAGE_LAYOUT_UNDEFINED);
+        REQUIRE(tracker.getImageLayout(image, 1) == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+        tracker.clearPendingBarriers();
+
+        // Mip 1 waits for the write, the others only change the layout, so they get separate barriers.
+        tracker.useImage(image, fragmentRead);
+        const std::vector<VkImageMemoryBarrier2> &barriers = tracker.getPendingImageBarriers();
+        REQUIRE(barriers.size() == 3);
+        REQUIRE(barriers[1].subresourceRange.baseMipLevel == 1);
+        REQUIRE(barriers[1].srcAccessMask == VK_ACCESS_2_TRANSFER_WRITE_BIT);
+        REQUIRE(barriers[0].srcAccessMask == VK_ACCESS_2_NONE);
+        REQUIRE(barriers[2].srcAccessMask == VK_ACCESS_2_NONE);
+    }
+
+    SECTION("A release hands the image to another queue family") {
+        tracker.useImage(image, transferWrite);
+        tracker.clearPendingBarriers();
+
+        tracker.releaseImage(image, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, 1, 0);
+        const std::vector<VkImageMemoryBarrier2> &barriers = tracker.getPendingImageBarriers();
+        REQUIRE(barriers.size() == 1);
+        REQUIRE(barriers[0].srcStageMask == VK_PIPELINE_STAGE_2_TRANSFER_BIT);
+        REQUIRE(barriers[0].dstStageMask == VK_PIPELINE_STAGE_2_NONE);
+        REQUIRE(barriers[0].srcQueueFamilyIndex == 1);
+        REQUIRE(barriers[0].dstQueueFamilyIndex == 0);
+        REQUIRE(tracker.getImageLayout(image) == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    }
+}
+
+TEST_CASE("Resource state tracker buffers", "[vulkan]") {
+    ResourceStateTracker tracker;
+    tracker.registerBuffer(buffer, 256);
+
+    const ResourceUsage bufferWrite{VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT};
+    const ResourceUsage bufferRead{VK_PIPELINE_STAGE_2_VERTEX_INPUT_BIT, VK_ACCESS_2_VERTEX_ATTRIBUTE_READ_BIT};
+
+    SECTION("Unwritten buffers are read without barriers") {
+        tracker.useBuffer(buffer, bufferRead);
+        REQUIRE_FALSE(tracker.hasPendingBarriers());
+    }
+
+    SECTION("Only the written range is synchronized") {
+        tracker.useBuffer(buffer, bufferWrite, 64, 64);
+        REQUIRE_FALSE(tracker.hasPendingBarriers());
+
+        tracker.useBuffer(buffer, bufferRead);
+        const std::vector<VkBufferMemoryBarrier2> &barriers = tracker.getPendingBufferBarriers();
+        REQUIRE(barriers.size() == 1);
+        REQUIRE(barriers[0].offset == 64);
+        REQUIRE(barriers[0].size == 64);
+        REQUIRE(barriers[0].srcAccessMask == VK_ACCESS_2_TRANSFER_WRITE_BIT);
+        REQUIRE(barriers[0].dstAccessMask == VK_ACCESS_2_VERTEX_ATTRIBUTE_READ_BIT);
+    }
+
+    SECTION("A write after reads waits for the reads without making anything visible") {
+        tracker.useBuffer(buffer, bufferRead);
+        tracker.useBuffer(buffer, bufferWrite);
+        const std::vector<VkBufferMemoryBarrier2> &barriers = tracker.getPendingBufferBarriers();
+        REQUIRE(barriers.size() == 1);
+        REQUIRE(barriers[0].srcStageMask == VK_PIPELINE_STAGE_2_VERTEX_INPUT_BIT);
+        REQUIRE(barriers[0].srcAccessMask == VK_ACCESS_2_NONE);
+        REQUIRE(barriers[0].offset == 0);
+        REQUIRE(barriers[0].size == 256);
+    }
+
+    SECTION("Cleared barriers are gone") {
+        tracker.useBuffer(buffer, bufferWrite);
+        tracker.useBuffer(buffer, bufferRead);
+        REQUIRE(tracker.hasPendingBarriers());
+        REQUIRE_FALSE(tracker.hasPendingBarriers(image));
+
+        tracker.clearPendingBarriers();
+        REQUIRE_FALSE(tracker.hasPendingBarriers());
+    }
+}
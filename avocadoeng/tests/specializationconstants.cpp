@@ -0,0 +1,90 @@
+#include "../src/vulkan/specializationconstants.hpp"
+
+#include <catch_amalgamated.hpp>
+
+#include <cstring>
+#include <string>
+
+using namespace avocado::vulkan;
+
+namespace {
+
+template <typename T>
+T readValue(const VkSpecializationInfo &info, const VkSpecializationMapEntry &entry) {
+    T value{};
+    std::memcpy(&value, static_cast<const char*>(info.pData) + entry.offset, sizeof(T));
+    return value;
+}
+
+std::string createKey(const SpecializationConstants &constants) {
+    std::string key;
+    constants.appendKey(key);
+    return key;
+}
+
+} // namespace.
+
+TEST_CASE("Specialization constants", "[vulkan]") {
+    SECTION("No constants give no specialization info") {
+        SpecializationConstants constants;
+        REQUIRE(constants.isEmpty());
+        REQUIRE(constants.createSpecializationInfo() == nullptr);
+    }
+
+    SECTION("Map entries are packed in id order") {
+        SpecializationConstants constants;
+        constants.set(7, 2.5f);
+        constants.set(1, true);
+        constants.set(3, uint64_t(42));
+
+        const VkSpecializationInfo *info = constants.createSpecializationInfo();
+        REQUIRE(info != nullptr);
+        REQUIRE(info->mapEntryCount == 3);
+        REQUIRE(info->dataSize == sizeof(VkBool32) + sizeof(uint64_t) + sizeof(float));
+
+        const VkSpecializationMapEntry *entries = info->pMapEntries;
+        REQUIRE(entries[0].constantID == 1);
+        REQUIRE(entries[0].offset == 0);
+        REQUIRE(entries[0].size == sizeof(VkBool32));
+        REQUIRE(readValue<VkBool32>(*info, entries[0]) == VK_TRUE);
+
+        REQUIRE(entries[1].constantID == 3);
+        REQUIRE(entries[1].offset == sizeof(VkBool32));
+        REQUIRE(entries[1].size == sizeof(uint64_t));
+        REQUIRE(readValue<uint64_t>(*info, entries[1]) == 42);
+
+        REQUIRE(entries[2].constantID == 7);
+        REQUIRE(entries[2].offset == sizeof(VkBool32) + sizeof(uint64_t));
+        REQUIRE(entries[2].size == sizeof(float));
+        REQUIRE(readValue<float>(*info, entries[2]) == 2.5f);
+    }
+
+    SECTION("Setting an id again overwrites its value and size") {
+        SpecializationConstants constants;
+        constants.set(0, int32_t(1));
+        constants.set(0, uint64_t(5));
+
+        const VkSpecializationInfo *info = constants.createSpecializationInfo();
+        REQUIRE(info->mapEntryCount == 1);
+        REQUIRE(info->dataSize == sizeof(uint64_t));
+        REQUIRE(info->pMapEntries[0].size == sizeof(uint64_t));
+        REQUIRE(readValue<uint64_t>(*info, info->pMapEntries[0]) == 5);
+    }
+
+    SECTION("The key depends on values but not on the order of set() calls") {
+        SpecializationConstants first;
+        first.set(0, 1);
+        first.set(1, false);
+
+        SpecializationConstants second;
+        second.set(1, false);
+        second.set(0, 1);
+        REQUIRE(createKey(first) == createKey(second));
+
+        second.set(0, 2);
+        REQUIRE(createKey(first) != createKey(second));
+
+        second.set(0, 1);
+        REQUIRE(createKey(first) == createKey(second));
+    }
+}
@@ -0,0 +1,105 @@
+#include "../src/spscqueue.hpp"
+
+#include <catch_amalgamated.hpp>
+
+#include <chrono>
+#include <thread>
+
+using namespace avocado::core;
+
+TEST_CASE("Single producer single consumer queue", "[core]") {
+    SECTION("Capacity is respected") {
+        SpscQueue<int> queue(2);
+        REQUIRE(queue.getCapacity() == 2);
+        REQUIRE(queue.isEmpty());
+        REQUIRE(queue.tryPush(1));
+        REQUIRE(queue.tryPush(2));
+        REQUIRE_FALSE(queue.tryPush(3));
+        REQUIRE_FALSE(queue.isEmpty());
+    }
+
+    SECTION("Values come out in push order") {
+        SpscQueue<int> queue(2);
+        int value = 0;
+        REQUIRE_FALSE(queue.tryPop(value));
+        for (int i = 0; i < 5; ++i) {
+            REQUIRE(queue.tryPush(int(i)));
+            REQUIRE(queue.tryPop(value));
+            REQUIRE(value == i);
+        }
+        REQUIRE(queue.isEmpty());
+    }
+
+    SECTION("Hand-off between threads") {
+        constexpr int count = 10000;
+        SpscQueue<int> queue(3);
+        std::thread producer([&queue]() {
+            for (int i = 0; i < count; ++i) {
+                while (!queue.tryPush(int(i)))
+                    std::this_thread::yield();
+            }
+        });
+
+        bool isOrdered = true;
+        for (int expected = 0; expected < count; ++expected) {
+            int value = -1;
+            while (!queue.tryPop(value))
+                std::this_thread::yield();
+            isOrdered = isOrdered && (value == expected);
+        }
+        producer.join();
+
+        REQUIRE(isOrdered);
+        REQUIRE(queue.isEmpty());
+    }
+
+    SECTION("Blocking hand-off between threads") {
+        constexpr int count = 10000;
+        SpscQueue<int> queue(2);
+        std::thread producer([&queue]() {
+            for (int i = 0; i < count; ++i)
+                queue.push(int(i));
+        });
+
+        bool isOrdered = true;
+        for (int expected = 0; expected < count; ++expected) {
+            int value = -1;
+            isOrdered = isOrdered && queue.pop(value) && (value == expected);
+        }
+        producer.join();
+
+        REQUIRE(isOrdered);
+        REQUIRE(queue.isEmpty());
+    }
+
+    SECTION("Closing wakes up a blocked consumer after the pushed values") {
+        SpscQueue<int> queue(2);
+        REQUIRE(queue.push(1));
+
+        int value = 0;
+        std::thread producer([&queue]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            queue.close();
+        });
+        REQUIRE(queue.pop(value));
+        REQUIRE(value == 1);
+        REQUIRE_FALSE(queue.pop(value));
+        producer.join();
+    }
+
+    SECTION("Closing wakes up a blocked producer") {
+        SpscQueue<int> queue(1);
+        REQUIRE(queue.push(1));
+
+        std::thread consumer([&queue]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            queue.close();
+        });
+        REQUIRE_FALSE(queue.push(2));
+        consumer.join();
+
+        int value = 0;
+        REQUIRE(queue.tryPop(value));
+        REQUIRE(value == 1);
+    }
+}
@@ -0,0 +1,94 @@
+#include "../src/vulkan/submissionbuilder.hpp"
+
+#include <catch_amalgamated.hpp>
+
+#include <cstdint>
+
+using namespace avocado::vulkan;
+
+namespace {
+
+// Fake handles, the builder only stores them.
+template <typename T>
+T createHandle(const uintptr_t value) {
+    return reinterpret_cast<T>(value);
+}
+
+} // namespace.
+
+TEST_CASE("Submission builder", "[vulkan]") {
+    VkSemaphore binarySemaphore = createHandle<VkSemaphore>(1);
+    VkSemaphore timelineSemaphore = createHandle<VkSemaphore>(2);
+    VkSemaphore signalSemaphore = createHandle<VkSemaphore>(3);
+    VkCommandBuffer firstCommandBuffer = createHandle<VkCommandBuffer>(4);
+    VkCommandBuffer secondCommandBuffer = createHandle<VkCommandBuffer>(5);
+
+    SECTION("Empty builder gives no submit infos") {
+        SubmissionBuilder submission;
+        REQUIRE(submission.isEmpty());
+        REQUIRE(submission.createSubmitInfos().empty());
+    }
+
+    SECTION("Commands and semaphores go to the last batch in the order they are added") {
+        SubmissionBuilder submission;
+        // Adding without nextBatch() starts the first batch.
+        submission.addCommandBuffer(firstCommandBuffer);
+        submission.nextBatch();
+        submission.addWaitSemaphore(binarySemaphore, VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT);
+        submission.addWaitSemaphore(timelineSemaphore, VK_PIPELINE_STAGE_2_VERTEX_INPUT_BIT, 7);
+        submission.addCommandBuffer(secondCommandBuffer);
+        submission.addSignalSemaphore(signalSemaphore, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT);
+        submission.addSignalSemaphore(timelineSemaphore, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, 8);
+        REQUIRE(!submission.isEmpty());
+
+        const std::vector<VkSubmitInfo2> submitInfos = submission.createSubmitInfos();
+        REQUIRE(submitInfos.size() == 2);
+
+        const VkSubmitInfo2 &first = submitInfos[0];
+        REQUIRE(first.sType == VK_STRUCTURE_TYPE_SUBMIT_INFO_2);
+        REQUIRE(first.waitSemaphoreInfoCount == 0);
+        REQUIRE(first.signalSemaphoreInfoCount == 0);
+        REQUIRE(first.commandBufferInfoCount == 1);
+        REQUIRE(first.pCommandBufferInfos[0].sType == VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO);
+        REQUIRE(first.pCommandBufferInfos[0].commandBuffer == firstCommandBuffer);
+
+        const VkSubmitInfo2 &second = submitInfos[1];
+        REQUIRE(second.commandBufferInfoCount == 1);
+        REQUIRE(second.pCommandBufferInfos[0].commandBuffer == secondCommandBuffer);
+
+        REQUIRE(second.waitSemaphoreInfoCount == 2);
+        const VkSemaphoreSubmitInfo *waits = second.pWaitSemaphoreInfos;
+        REQUIRE(waits[0].sType == VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO);
+        REQUIRE(waits[0].semaphore == binarySemaphore);
+        REQUIRE(waits[0].stageMask == VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT);
+        REQUIRE(waits[0].value == 0);
+        REQUIRE(waits[1].semaphore == timelineSemaphore);
+        REQUIRE(waits[1].stageMask == VK_PIPELINE_STAGE_2_VERTEX_INPUT_BIT);
+        REQUIRE(waits[1].value == 7);
+
+        REQUIRE(second.signalSemaphoreInfoCount == 2);
+        const VkSemaphoreSubmitInfo *signals = second.pSignalSemaphoreInfos;
+        REQUIRE(signals[0].semaphore == signalSemaphore);
+        REQUIRE(signals[0].stageMask == VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT);
+        REQUIRE(signals[0].value == 0);
+        REQUIRE(signals[1].semaphore == timelineSemaphore);
+        REQUIRE(signals[1].value == 8);
+    }
+
+    SECTION("Clearing drops all batches") {
+        // Queue::submit() clears the builder after vkQueueSubmit2, so it can be reused for the next frame.
+        SubmissionBuilder submission;
+        submission.addWaitSemaphore(timelineSemaphore, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, 3);
+        submission.addCommandBuffer(firstCommandBuffer);
+        submission.clear();
+        REQUIRE(submission.isEmpty());
+        REQUIRE(submission.createSubmitInfos().empty());
+
+        submission.addCommandBuffer(secondCommandBuffer);
+        const std::vector<VkSubmitInfo2> submitInfos = submission.createSubmitInfos();
+        REQUIRE(submitInfos.size() == 1);
+        REQUIRE(submitInfos[0].waitSemaphoreInfoCount == 0);
+        REQUIRE(submitInfos[0].commandBufferInfoCount == 1);
+        REQUIRE(submitInfos[0].pCommandBufferInfos[0].commandBuffer == secondCommandBuffer);
+    }
+}
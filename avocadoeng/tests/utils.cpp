@@ -0,0 +1,38 @@
+#include "../src/utils.hpp"
+
+#include <catch_amalgamated.hpp>
+
+#include <string>
+#include <vector>
+
+using namespace avocado::utils;
+
+TEST_CASE("Hashing utilities", "[utils]") {
+    SECTION("FNV-1a reference values") {
+        REQUIRE(hashBytes("", 0) == 14695981039346656037ull);
+        REQUIRE(hashBytes("a", 1) == 0xaf63dc4c8601ec8cull);
+        REQUIRE(hashBytes("foobar", 6) == 0x85944171f73967e8ull);
+    }
+
+    SECTION("Hashing can be continued with a seed") {
+        REQUIRE(hashBytes("bar", 3, hashBytes("foo", 3)) == hashBytes("foobar", 6));
+    }
+
+    SECTION("Equal values give equal keys") {
+        std::string a, b;
+        appendKeyBytes(a, 42u);
+        appendKeyBytes(a, std::vector<int>{1, 2, 3});
+        appendKeyBytes(b, 42u);
+        appendKeyBytes(b, std::vector<int>{1, 2, 3});
+        REQUIRE(a == b);
+    }
+
+    SECTION("Vector boundaries are part of the key") {
+        std::string a, b;
+        appendKeyBytes(a, std::vector<int>{1, 2});
+        appendKeyBytes(a, std::vector<int>{});
+        appendKeyBytes(b, std::vector<int>{1});
+        appendKeyBytes(b, std::vector<int>{2});
+        REQUIRE(a != b);
+    }
+}
@@ -1,5 +1,5 @@
 $path = ".\assets\shaders"
-Get-ChildItem "$path\*" -Include "*.frag", "*.vert" |
+Get-ChildItem "$path\*" -Include "*.frag", "*.vert", "*.comp" |
 Foreach-Object {
     Write-Output "Compiling $_..."
     glslc.exe $_ -o "$_.spv"
@@ -14,5 +14,12 @@ do
     glslc $file -o $file.spv
 done
 
+# Compute shaders.
+for file in ./assets/shaders/*.comp
+do
+    echo "Compiling $file..."
+    glslc $file -o $file.spv
+done
+
 exit
 
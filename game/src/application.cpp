@@ -9,15 +9,24 @@
 #include <math/matrix.hpp>
 #include <math/vecn.hpp>
 
+#include <vulkan/asynccompute.hpp>
 #include <vulkan/buffer.hpp>
 #include <vulkan/clipping.hpp>
 #include <vulkan/commandbuffer.hpp>
+#include <vulkan/commandbuffercache.hpp>
+#include <vulkan/computepipeline.hpp>
 #include <vulkan/debugutils.hpp>
+#include <vulkan/descriptorsetcache.hpp>
+#include <vulkan/descriptorupdatetemplate.hpp>
+#include <vulkan/framedescriptorallocator.hpp>
+#include <vulkan/framescheduler.hpp>
 #include <vulkan/image.hpp>
 #include <vulkan/logicaldevice.hpp>
+#include <vulkan/pipelinecompiler.hpp>
 #include <vulkan/pointertypes.hpp>
 #include <vulkan/surface.hpp>
 #include <vulkan/swapchain.hpp>
+#include <vulkan/uploadbatch.hpp>
 #include <vulkan/states/colorblendstate.hpp>
 #include <vulkan/states/dynamicstate.hpp>
 #include <vulkan/states/inputasmstate.hpp>
@@ -28,6 +37,7 @@
 #include <vulkan/vkutils.hpp>
 
 #include <core.hpp>
+#include <spscqueue.hpp>
 
 #include <SDL_vulkan.h>
 #include <SDL_image.h>
@@ -40,116 +50,12 @@
 #include <vulkan/vulkan_core.h>
 #include <vulkan/structuretypes.hpp>
 
+#include <atomic>
+#include <cstddef>
 #include <filesystem>
 #include <iostream>
 #include <memory>
-
-VkCommandBuffer beginSingleTimeCommands(avocado::vulkan::LogicalDevice &logicalDevice, VkCommandPool commandPool) {
-    VkCommandBufferAllocateInfo allocInfo{};
-    FILL_S_TYPE(allocInfo);
-
-    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-    allocInfo.commandPool = commandPool;
-    allocInfo.commandBufferCount = 1;
-
-    VkCommandBuffer commandBuffer;
-    vkAllocateCommandBuffers(logicalDevice.getHandle(), &allocInfo, &commandBuffer);
-
-    VkCommandBufferBeginInfo beginInfo{};
-    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
-
-    vkBeginCommandBuffer(commandBuffer, &beginInfo);
-
-    return commandBuffer;
-}
-
-void endSingleTimeCommands(avocado::vulkan::LogicalDevice &logicalDevice, VkCommandPool commandPool, avocado::vulkan::Queue &graphicsQueue, VkCommandBuffer commandBuffer) {
-    vkEndCommandBuffer(commandBuffer);
-
-    VkSubmitInfo submitInfo{};
-    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-    submitInfo.commandBufferCount = 1;
-    submitInfo.pCommandBuffers = &commandBuffer;
-
-    VkResult res = vkQueueSubmit(graphicsQueue.getHandle(), 1, &submitInfo, VK_NULL_HANDLE);
-    if (res != VK_SUCCESS) {
-        std::cout << "QUEUE SUBMIT ERROR" << std::endl;
-        return;
-    }
-    res = vkQueueWaitIdle(graphicsQueue.getHandle());
-    if (res != VK_SUCCESS) {
-        std::cout << "QUEUE WAIT IDLE ERROR" << std::endl;
-        return;
-    }
-
-    vkFreeCommandBuffers(logicalDevice.getHandle(), commandPool, 1, &commandBuffer);
-}
-
-void transitionImageLayout(avocado::vulkan::LogicalDevice &logicalDevice, VkCommandPool commandPool, avocado::vulkan::Queue &queue, VkImage image, VkFormat format, VkImageLayout oldLayout, VkImageLayout newLayout) {
-    VkCommandBuffer commandBuffer = beginSingleTimeCommands(logicalDevice, commandPool);
-    VkImageMemoryBarrier barrier{};
-    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-    barrier.oldLayout = oldLayout;
-    barrier.newLayout = newLayout;
-    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
-    barrier.image = image;
-    barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-    barrier.subresourceRange.baseMipLevel = 0;
-    barrier.subresourceRange.levelCount = 1;
-    barrier.subresourceRange.baseArrayLayer = 0;
-    barrier.subresourceRange.layerCount = 1;
-
-    VkPipelineStageFlags srcStage, dstStage;
-    if (oldLayout == VK_IMAGE_LAYOUT_UNDEFINED && newLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL) {
-            barrier.srcAccessMask = 0;
-            barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-
-            srcStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-            dstStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-        } else if (oldLayout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL && newLayout == VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL) {
-            barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-            barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-
-            srcStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
-            dstStage = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
-        } else {
-            throw std::invalid_argument("unsupported layout transition!");
-        }
-
-    vkCmdPipelineBarrier( commandBuffer, srcStage, dstStage, 0, 0, nullptr, 0, nullptr, 1, &barrier);
-    endSingleTimeCommands(logicalDevice, commandPool, queue, commandBuffer);
-}
-
-void copyBufferToImage(avocado::vulkan::LogicalDevice &logicalDevice, VkCommandPool commandPool, avocado::vulkan::Queue &queue, avocado::vulkan::Buffer &buffer,
-    avocado::vulkan::Image &image, uint32_t width, uint32_t height) {
-    const std::vector commandBuffers = logicalDevice.allocateCommandBuffers(1, commandPool, VK_COMMAND_BUFFER_LEVEL_PRIMARY);
-    avocado::vulkan::CommandBuffer commandBuffer = commandBuffers.front();
-
-    // todo Shouldn't be in that way. It's possible to forget to begin command buffer and no info about it.
-    // copyToImage is a command for command buffer.
-    commandBuffer.begin();
-    buffer.copyToImage(image, width, height, commandBuffer);
-    commandBuffer.end();
-
-    VkCommandBuffer bufferHandle = commandBuffer.getHandle();
-    VkSubmitInfo submitInfo{};
-    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-    submitInfo.commandBufferCount = 1;
-    submitInfo.pCommandBuffers = &bufferHandle;
-    queue.submit(submitInfo);
-    if (queue.hasError()) {
-        std::cout << "Queue submit error (" << queue.getErrorMessage() << ')' << std::endl;
-        return;
-    }
-
-    queue.waitIdle();
-    if (queue.hasError()) {
-        std::cout << "Queue wait idle error (" << queue.getErrorMessage() << ')' << std::endl;
-        return;
-    }
-}
+#include <thread>
 
 void Application::createInstance(SDL_Window &window, const std::vector<std::string> &instanceLayers) {
     const bool areLayersSupported = _vulkan.areLayersSupported(instanceLayers);
@@ -261,14 +167,12 @@ avocado::vulkan::GraphicsPipelineBuilder Application::preparePipeline(const VkEx
         return pipelineBuilder;
     }
 
-    { // Clear vector buffers immediatly after use.
-        const std::vector<char> &fragBuf = avocado::utils::readFile(Config::SHADERS_PATH + "/triangle.frag.spv");
-        const std::vector<char> &vertBuf = avocado::utils::readFile(Config::SHADERS_PATH + "/triangle.vert.spv");
-        pipelineBuilder.addVertexShaderModules({vertBuf});
-        pipelineBuilder.addFragmentShaderModules({fragBuf});
-    }
+    pipelineBuilder.addShaderModuleFile(Config::SHADERS_PATH + "/triangle.vert.spv", VK_SHADER_STAGE_VERTEX_BIT);
+    pipelineBuilder.addShaderModuleFile(Config::SHADERS_PATH + "/triangle.frag.spv", VK_SHADER_STAGE_FRAGMENT_BIT);
 
     auto dynState = std::make_unique<avocado::vulkan::DynamicState>(std::vector<VkDynamicState>{VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR});
+    // Set while recording, so materials which differ only in these states share the pipeline.
+    dynState->addDynamicStates({VK_DYNAMIC_STATE_CULL_MODE, VK_DYNAMIC_STATE_FRONT_FACE, VK_DYNAMIC_STATE_PRIMITIVE_TOPOLOGY});
     pipelineBuilder.setDynamicState(std::move(dynState));
 
     auto inAsmState = std::make_unique<avocado::vulkan::InputAsmState>(VK_PRIMITIVE_TOPOLOGY_TRIANGLE_FAN);
@@ -309,38 +213,35 @@ avocado::vulkan::GraphicsPipelineBuilder Application::preparePipeline(const VkEx
     return pipelineBuilder;
 }
 
-void Application::updateDescriptorSets(std::vector<avocado::vulkan::Buffer*> &uniformBuffers, const VkDeviceSize range, std::vector<VkDescriptorSet> &descriptorSets,
-    avocado::vulkan::ImageViewPtr &textureImageView, avocado::vulkan::SamplerPtr &textureSampler) {
-    std::array<VkWriteDescriptorSet, 2> descriptorWrites{};
-    for (size_t i = 0; i < 2; i++) {
-        VkDescriptorBufferInfo bufferInfo{};
-        bufferInfo.buffer = uniformBuffers[i]->getHandle();
-        bufferInfo.offset = 0;
-        bufferInfo.range = range;
-
-        descriptorWrites[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-        descriptorWrites[0].dstSet = descriptorSets[i];
-        descriptorWrites[0].dstBinding = 0;
-        descriptorWrites[0].dstArrayElement = 0;
-        descriptorWrites[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-        descriptorWrites[0].descriptorCount = 1;
-        descriptorWrites[0].pBufferInfo = &bufferInfo;
-
-        VkDescriptorImageInfo imageInfo{};
-        imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-        imageInfo.imageView = textureImageView.get();
-        imageInfo.sampler = textureSampler.get();
-
-        descriptorWrites[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-        descriptorWrites[1].dstSet = descriptorSets[i];
-        descriptorWrites[1].dstBinding = 1;
-        descriptorWrites[1].dstArrayElement = 0;
-        descriptorWrites[1].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-        descriptorWrites[1].descriptorCount = 1;
-        descriptorWrites[1].pImageInfo = &imageInfo;
-
-        vkUpdateDescriptorSets(_logicalDevice.getHandle(), descriptorWrites.size(), descriptorWrites.data(), 0, nullptr);
+bool Application::getDescriptorSets(VkDescriptorSetLayout layout, std::vector<avocado::vulkan::Buffer*> &uniformBuffers, const VkDeviceSize range,
+    std::vector<VkDescriptorSet> &descriptorSets, avocado::vulkan::ImageViewPtr &textureImageView, VkSampler textureSampler) {
+    // The sets are cached with their resources, the cache invalidates them when a resource is destroyed.
+    avocado::vulkan::DescriptorSetCache &descriptorSetCache = _logicalDevice.getDescriptorSetCache();
+    descriptorSets.clear();
+    for (avocado::vulkan::Buffer *uniformBuffer : uniformBuffers) {
+        descriptorSets.push_back(descriptorSetCache.get(layout, {
+            avocado::vulkan::DescriptorResource::createBuffer(0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, uniformBuffer->getHandle(), 0, range),
+            avocado::vulkan::DescriptorResource::createImage(1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, textureImageView.get(), textureSampler)
+        }));
+        if (descriptorSetCache.hasError()) {
+            std::cout << "Can't get descriptor set: " << descriptorSetCache.getErrorMessage() << std::endl;
+            return false;
+        }
     }
+
+    return true;
+}
+
+void Application::setFramesInFlight(const uint32_t framesInFlight) noexcept {
+    assert(framesInFlight > 0);
+
+    _framesInFlight = framesInFlight;
+}
+
+void Application::setRenderPacketQueueDepth(const size_t renderPacketQueueDepth) noexcept {
+    assert(renderPacketQueueDepth > 0);
+
+    _renderPacketQueueDepth = renderPacketQueueDepth;
 }
 
 int Application::run() {
@@ -355,7 +256,7 @@ int Application::run() {
     createInstance(*sdlWindow, instanceLayers);
     createPhysicalDevice();
 
-    const std::vector<std::string> physExtensions {VK_KHR_SWAPCHAIN_EXTENSION_NAME};
+    std::vector<std::string> physExtensions {VK_KHR_SWAPCHAIN_EXTENSION_NAME};
     const bool areExtensionsSupported = _physicalDevice.areExtensionsSupported(physExtensions);
     if (_physicalDevice.hasError()) {
         std::cerr << "Extensions error: " << _physicalDevice.getErrorMessage() << std::endl;
@@ -367,6 +268,20 @@ int Application::run() {
         return 1;
     }
 
+    // Optional, pipelines are compiled monolithically without it.
+    if (_physicalDevice.isGraphicsPipelineLibrarySupported()) {
+        physExtensions.push_back(VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME);
+        physExtensions.push_back(VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME);
+    }
+
+    // Optional, per-draw descriptors are written into allocated sets without it.
+    if (_physicalDevice.isPushDescriptorSupported())
+        physExtensions.push_back(VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME);
+
+    // Optional, shader modules are always created without it.
+    if (_physicalDevice.isShaderModuleIdentifierSupported())
+        physExtensions.push_back(VK_EXT_SHADER_MODULE_IDENTIFIER_EXTENSION_NAME);
+
     avocado::vulkan::Surface surface = _vulkan.createSurface(sdlWindow.get(), _physicalDevice);
     if (_vulkan.hasError()) {
         std::cerr << "Can't create surface: " << _vulkan.getErrorMessage() << std::endl;
@@ -380,6 +295,8 @@ int Application::run() {
     }
     const avocado::vulkan::QueueFamily graphicsQueueFamily = _physicalDevice.getGraphicsQueueFamily();
     const avocado::vulkan::QueueFamily presentQueueFamily = _physicalDevice.getPresentQueueFamily();
+    const avocado::vulkan::QueueFamily transferQueueFamily = _physicalDevice.getTransferQueueFamily();
+    const avocado::vulkan::QueueFamily computeQueueFamily = _physicalDevice.getComputeQueueFamily();
 
     if (surface.hasError()) {
         std::cout << "Can't get present queue family index: " << surface.getErrorMessage() << std::endl;
@@ -389,12 +306,24 @@ int Application::run() {
     std::vector queueFamilies {graphicsQueueFamily, presentQueueFamily};
     avocado::utils::makeUniqueContainer(queueFamilies);
 
-    _logicalDevice = _physicalDevice.createLogicalDevice(queueFamilies, physExtensions, instanceLayers, 1, 1.0f);
+    std::vector deviceQueueFamilies {graphicsQueueFamily, presentQueueFamily, transferQueueFamily, computeQueueFamily};
+    avocado::utils::makeUniqueContainer(deviceQueueFamilies);
+
+    _logicalDevice = _physicalDevice.createLogicalDevice(deviceQueueFamilies, physExtensions, instanceLayers, 1, 1.0f);
     if (_physicalDevice.hasError()) {
         std::cerr << "Can't create logical device: " << _physicalDevice.getErrorMessage() << std::endl;
         return 1;
     }
 
+    // A stale or missing cache is not an error, pipelines are just compiled from scratch.
+    avocado::vulkan::PipelineCache &pipelineCache = _logicalDevice.getPipelineCache();
+    if (!pipelineCache.load(Config::PIPELINE_CACHE_PATH, _physicalDevice.getProperties()))
+        std::cout << "Pipeline cache " << Config::PIPELINE_CACHE_PATH << " is not used." << std::endl;
+    if (pipelineCache.hasError()) {
+        std::cerr << "Can't load pipeline cache: " << pipelineCache.getErrorMessage() << std::endl;
+        return 1;
+    }
+
     auto debugUtilsPtr = _logicalDevice.createDebugUtils();
 
     avocado::vulkan::Queue presentQueue = _logicalDevice.getPresentQueue(0);
@@ -420,8 +349,9 @@ int Application::run() {
     constexpr std::array<uint16_t, 6> indices {0, 1, 2, 2, 3, 0};
     constexpr size_t indicesSizeBytes = indices.size() * sizeof(decltype(indices)::value_type);
 
+    // The source of the animated vertices, which the compute shader writes per frame.
     avocado::vulkan::Buffer vertexBuffer(verticesSizeBytes,
-        static_cast<VkBufferUsageFlagBits>(VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT),
+        static_cast<VkBufferUsageFlagBits>(VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT),
         VK_SHARING_MODE_EXCLUSIVE,
         _logicalDevice);
 
@@ -430,7 +360,8 @@ int Application::run() {
         return 1;
     }
 
-    vertexBuffer.allocateMemory(_physicalDevice, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT);
+    // The quad is written through a mapping, it goes to host-visible VRAM when the device has enough of it.
+    vertexBuffer.allocateMemory(_physicalDevice, avocado::vulkan::MemoryUsage::DynamicPerFrame);
     if (vertexBuffer.hasError()) {
         std::cout << "Can't allocate memory on vertex buf: " << vertexBuffer.getErrorMessage() << std::endl;
         return 1;
@@ -446,7 +377,7 @@ int Application::run() {
         std::cout << "Can't create index buffer: " << indexBuffer.getErrorMessage() << std::endl;
         return 1;
     }
-    indexBuffer.allocateMemory(_physicalDevice, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT);
+    indexBuffer.allocateMemory(_physicalDevice, avocado::vulkan::MemoryUsage::DynamicPerFrame);
     if (indexBuffer.hasError()) {
         std::cout << "Can't allocate memory on index buffer: " << indexBuffer.getErrorMessage() << std::endl;
         return 1;
@@ -465,120 +396,165 @@ int Application::run() {
         alignas(16) avocado::math::Mat4x4 view;
     };
 
-    avocado::vulkan::Buffer uniformBuffer(sizeof(UniformBufferObject), static_cast<VkBufferUsageFlagBits>(VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT), VK_SHARING_MODE_EXCLUSIVE, _logicalDevice);
-    uniformBuffer.allocateMemory(_physicalDevice, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
-    uniformBuffer.bindMemory();
-
-    avocado::vulkan::Buffer uniformBufferForFrame2(sizeof(UniformBufferObject), static_cast<VkBufferUsageFlagBits>(VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT), VK_SHARING_MODE_EXCLUSIVE, _logicalDevice);
-    uniformBufferForFrame2.allocateMemory(_physicalDevice, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
-    uniformBufferForFrame2.bindMemory();
+    // Synchronization objects.
+    avocado::vulkan::FrameScheduler frameScheduler(_logicalDevice, _framesInFlight);
+    if (frameScheduler.hasError()) {
+        std::cout << "Can't create frame scheduler: " << frameScheduler.getErrorMessage() << std::endl;
+        return 1;
+    }
 
-    UniformBufferObject ubo{};
-    ubo.view = avocado::math::lookAt(avocado::math::vec3f(0.f, 0.f, 2.f), avocado::math::vec3f(0.f, 0.f, 0.f), avocado::math::vec3f(0.f, 1.f, 0.f));
-    ubo.proj = avocado::math::perspectiveProjection(45.f, static_cast<float>(Config::RESOLUTION_WIDTH) / static_cast<float>(Config::RESOLUTION_HEIGHT), 0.1f, 10.f);
+    std::vector<avocado::vulkan::Buffer> uniformBufferStorage;
+    std::vector<avocado::vulkan::Buffer*> uniformBuffers;
+    uniformBufferStorage.reserve(_framesInFlight);
+    for (uint32_t i = 0; i < _framesInFlight; ++i) {
+        avocado::vulkan::Buffer &uniformBuffer = uniformBufferStorage.emplace_back(sizeof(UniformBufferObject), static_cast<VkBufferUsageFlagBits>(VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT), VK_SHARING_MODE_EXCLUSIVE, _logicalDevice);
+        uniformBuffer.allocateMemory(_physicalDevice, avocado::vulkan::MemoryUsage::DynamicPerFrame);
+        uniformBuffer.bindMemory();
+        uniformBuffers.push_back(&uniformBuffer);
+    }
 
-    auto renderPassPtr = _logicalDevice.createRenderPass(surfaceFormat.format);
+    // The quad is animated on the compute queue, overlapping with rendering of the previous frame.
+    // Each frame slot has its own vertex buffer, which is handed over to the graphics queue family.
+    struct QuadConstants {
+        float time;
+        uint32_t vertexCount;
+    };
 
-    // Create descriptor set layout.
-    VkDescriptorSetLayout descriptorSetLayout;
-    VkDescriptorSetLayoutBinding uboLayoutBinding{};
-    uboLayoutBinding.binding = 0;
-    uboLayoutBinding.descriptorCount = 1;
-    uboLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-    uboLayoutBinding.pImmutableSamplers = nullptr;
-    uboLayoutBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+    std::vector<avocado::vulkan::Buffer> animatedVertexBuffers;
+    animatedVertexBuffers.reserve(_framesInFlight);
+    for (uint32_t i = 0; i < _framesInFlight; ++i) {
+        avocado::vulkan::Buffer &animatedVertexBuffer = animatedVertexBuffers.emplace_back(verticesSizeBytes,
+            static_cast<VkBufferUsageFlagBits>(VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT),
+            VK_SHARING_MODE_EXCLUSIVE, _logicalDevice);
+        animatedVertexBuffer.allocateMemory(_physicalDevice, avocado::vulkan::MemoryUsage::GpuOnly);
+        animatedVertexBuffer.bindMemory();
+        if (animatedVertexBuffer.hasError()) {
+            std::cout << "Can't create animated vertex buffer: " << animatedVertexBuffer.getErrorMessage() << std::endl;
+            return 1;
+        }
+    }
 
-    VkDescriptorSetLayoutBinding samplerLayoutBinding{};
-    samplerLayoutBinding.binding = 1;
-    samplerLayoutBinding.descriptorCount = 1;
-    samplerLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    samplerLayoutBinding.pImmutableSamplers = nullptr;
-    samplerLayoutBinding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+    const std::vector<VkDescriptorSetLayoutBinding> computeBindings {
+        _logicalDevice.createLayoutBinding(0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT),
+        _logicalDevice.createLayoutBinding(1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 1, VK_SHADER_STAGE_COMPUTE_BIT)
+    };
+    avocado::vulkan::DescriptorSetLayoutPtr computeDescriptorSetLayoutPtr = _logicalDevice.createObjectPointer(
+        _logicalDevice.createDescriptorSetLayout(computeBindings));
+    if (_logicalDevice.hasError()) {
+        std::cout << "Can't create compute descriptor set layout: " << _logicalDevice.getErrorMessage() << std::endl;
+        return 1;
+    }
 
-    std::array<VkDescriptorSetLayoutBinding, 2> bindings {uboLayoutBinding, samplerLayoutBinding};
+    std::vector<VkDescriptorSetLayout> computeLayouts {computeDescriptorSetLayoutPtr.get()};
+    avocado::vulkan::ComputePipelineBuilder computePipelineBuilder(_logicalDevice);
+    computePipelineBuilder.setShaderModuleFile(Config::SHADERS_PATH + "/quad.comp.spv");
+    computePipelineBuilder.setDescriptorSetLayouts(computeLayouts);
+    computePipelineBuilder.addPushConstantRange(0, sizeof(QuadConstants));
+    avocado::vulkan::PipelinePtr computePipeline = computePipelineBuilder.buildPipeline();
+    if (computePipelineBuilder.hasError()) {
+        std::cout << "Can't create compute pipeline: " << computePipelineBuilder.getErrorMessage() << std::endl;
+        return 1;
+    }
+    const VkPipelineLayout computePipelineLayout = computePipelineBuilder.getPipelineLayout();
 
-    VkDescriptorSetLayoutCreateInfo layoutInfo{};
-    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
-    layoutInfo.bindingCount = bindings.size();
-    layoutInfo.pBindings = bindings.data();
+    // The compute set is allocated every frame from the pools of the frame slot, which are reset as a whole
+    // when the slot is reused, and written with one template update.
+    struct QuadDescriptors {
+        VkDescriptorBufferInfo sourceVertices;
+        VkDescriptorBufferInfo vertices;
+    };
 
-    if (vkCreateDescriptorSetLayout(_logicalDevice.getHandle(), &layoutInfo, nullptr, &descriptorSetLayout) != VK_SUCCESS) {
-        std::cout << "failed to create descriptor set layout!" << std::endl;
+    avocado::vulkan::DescriptorUpdateTemplate computeUpdateTemplate(_logicalDevice.getHandle());
+    computeUpdateTemplate.addEntry(0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, offsetof(QuadDescriptors, sourceVertices));
+    computeUpdateTemplate.addEntry(1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, offsetof(QuadDescriptors, vertices));
+    computeUpdateTemplate.create(computeDescriptorSetLayoutPtr.get());
+    if (computeUpdateTemplate.hasError()) {
+        std::cout << "Can't create compute descriptor update template: " << computeUpdateTemplate.getErrorMessage() << std::endl;
         return 1;
     }
 
-    avocado::vulkan::DescriptorSetLayoutPtr descriptorSetLayoutPtr = _logicalDevice.createObjectPointer(descriptorSetLayout);
+    avocado::vulkan::FrameDescriptorAllocator frameDescriptorAllocator(_logicalDevice.getHandle(), _framesInFlight);
 
-    std::vector<VkDescriptorSet> descriptorSets;
-    avocado::vulkan::DescriptorPoolPtr descriptorPool = _logicalDevice.createObjectPointer(_logicalDevice.createDescriptorPool(FRAMES_IN_FLIGHT));
+    avocado::vulkan::Queue computeQueue(_logicalDevice.getComputeQueue(0));
+    avocado::vulkan::AsyncCompute asyncCompute(_logicalDevice, computeQueueFamily, _framesInFlight);
+    if (asyncCompute.hasError()) {
+        std::cout << "Can't create async compute: " << asyncCompute.getErrorMessage() << std::endl;
+        return 1;
+    }
 
-    std::vector<avocado::vulkan::Buffer*> uniformBuffers = {&uniformBuffer, &uniformBufferForFrame2};
+    UniformBufferObject ubo{};
+    ubo.view = avocado::math::lookAt(avocado::math::vec3f(0.f, 0.f, 2.f), avocado::math::vec3f(0.f, 0.f, 0.f), avocado::math::vec3f(0.f, 1.f, 0.f));
+    ubo.proj = avocado::math::perspectiveProjection(45.f, static_cast<float>(Config::RESOLUTION_WIDTH) / static_cast<float>(Config::RESOLUTION_HEIGHT), 0.1f, 10.f);
 
-    // Create descriptor sets.
-    std::vector<VkDescriptorSetLayout> layouts(FRAMES_IN_FLIGHT, descriptorSetLayoutPtr.get());
-    VkDescriptorSetAllocateInfo allocInfo{};
-    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-    allocInfo.descriptorPool = descriptorPool.get();
-    allocInfo.descriptorSetCount = static_cast<uint32_t>(FRAMES_IN_FLIGHT);
-    allocInfo.pSetLayouts = layouts.data();
+    auto renderPassPtr = _logicalDevice.createRenderPass(surfaceFormat.format);
 
-    descriptorSets.resize(FRAMES_IN_FLIGHT);
-    const VkResult ads = vkAllocateDescriptorSets(_logicalDevice.getHandle(), &allocInfo, descriptorSets.data());
-    if (ads != VK_SUCCESS) {
-        throw std::runtime_error("Can't allocate descriptor sets"s + std::to_string(static_cast<int>(ads)));
+    // Per-draw descriptors are pushed while recording if the device can, no sets are allocated then.
+    const bool isPushDescriptorEnabled = _logicalDevice.isPushDescriptorEnabled();
+    const std::vector<VkDescriptorSetLayoutBinding> bindings {
+        _logicalDevice.createLayoutBinding(0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1, VK_SHADER_STAGE_VERTEX_BIT),
+        _logicalDevice.createLayoutBinding(1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_FRAGMENT_BIT)
+    };
+    VkDescriptorSetLayout descriptorSetLayout = _logicalDevice.createDescriptorSetLayout(bindings, isPushDescriptorEnabled);
+    if (_logicalDevice.hasError()) {
+        std::cout << "Can't create descriptor set layout: " << _logicalDevice.getErrorMessage() << std::endl;
+        return 1;
     }
 
+    avocado::vulkan::DescriptorSetLayoutPtr descriptorSetLayoutPtr = _logicalDevice.createObjectPointer(descriptorSetLayout);
+
+    std::vector<VkDescriptorSetLayout> layouts(_framesInFlight, descriptorSetLayoutPtr.get());
+
     const std::vector<VkViewport> viewPorts { avocado::vulkan::Clipping::createViewport(0.f, 0.f, extent) };
     const std::vector<VkRect2D> scissors { avocado::vulkan::Clipping::createScissor(viewPorts.front()) };
-    avocado::vulkan::GraphicsPipelineBuilder pipelineBuilder = preparePipeline(extent, layouts, viewPorts, scissors);
-    avocado::vulkan::PipelinePtr graphicsPipeline = pipelineBuilder.buildPipeline(renderPassPtr.get());
-
-    if (graphicsPipeline == nullptr) {
-        std::cout << "Error: invalid pipeline" << std::endl;
+    // All pipeline permutations compile on worker threads while the texture is loaded and uploaded.
+    // Materials with the same state get the same pipeline from the registry.
+    avocado::vulkan::PipelineCompiler pipelineCompiler(_logicalDevice, _pipelineCompilerThreadCount);
+    if (pipelineCompiler.hasError()) {
+        std::cout << "Can't create pipeline compiler: " << pipelineCompiler.getErrorMessage() << std::endl;
         return 1;
     }
 
-    avocado::vulkan::CommandPoolPtr commandPool = _logicalDevice.createObjectPointer(_logicalDevice.createCommandPool(VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT, graphicsQueueFamily));
-    if (_logicalDevice.hasError()) {
-        std::cout << "Can't create command pool: " << _logicalDevice.getErrorMessage() << std::endl;
+    std::vector<avocado::vulkan::PipelineRequest> pipelineRequests;
+    avocado::vulkan::PipelineRequest &scenePipelineRequest = pipelineRequests.emplace_back();
+    scenePipelineRequest.builder = std::make_unique<avocado::vulkan::GraphicsPipelineBuilder>(preparePipeline(extent, layouts, viewPorts, scissors));
+    scenePipelineRequest.renderPass = renderPassPtr.get();
+    const VkPipelineLayout pipelineLayout = scenePipelineRequest.builder->preparePipelineLayout();
+    if (scenePipelineRequest.builder->hasError()) {
+        std::cout << "Error: invalid pipeline layout (" << scenePipelineRequest.builder->getErrorMessage() << ")" << std::endl;
         return 1;
     }
+    // The fast-linked pipeline is replaced in the registry by the optimized one, which is looked up by this key.
+    const std::string scenePipelineKey = scenePipelineRequest.builder->createStateKey(renderPassPtr.get());
 
-    std::vector<avocado::vulkan::CommandBuffer> cmdBuffers = _logicalDevice.allocateCommandBuffers(FRAMES_IN_FLIGHT, commandPool.get(), VK_COMMAND_BUFFER_LEVEL_PRIMARY);
-    if (_logicalDevice.hasError()) {
-        std::cout << "Can't allocate command buffers (" << _logicalDevice.getErrorMessage() << ")." << std::endl;
+    const std::vector<avocado::vulkan::PipelineFuture> pipelineFutures = pipelineCompiler.precompile(std::move(pipelineRequests));
+    if (pipelineCompiler.hasError()) {
+        std::cout << "Error: invalid pipeline (" << pipelineCompiler.getErrorMessage() << ")" << std::endl;
         return 1;
     }
 
-    // Synchronization objects.
-    std::array<avocado::vulkan::SemaphorePtr, FRAMES_IN_FLIGHT> imageAvailableSemaphores = {
-        _logicalDevice.createObjectPointer(_logicalDevice.createSemaphore()),
-        _logicalDevice.createObjectPointer(_logicalDevice.createSemaphore())};
+    avocado::vulkan::CommandPoolPtr commandPool = _logicalDevice.createObjectPointer(_logicalDevice.createCommandPool(VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT, graphicsQueueFamily));
     if (_logicalDevice.hasError()) {
-        std::cout << "Can't create semaphore: " << _logicalDevice.getErrorMessage() << std::endl;
+        std::cout << "Can't create command pool: " << _logicalDevice.getErrorMessage() << std::endl;
         return 1;
     }
 
-    std::array<avocado::vulkan::SemaphorePtr, FRAMES_IN_FLIGHT> renderFinishedSemaphores = {
-        _logicalDevice.createObjectPointer(_logicalDevice.createSemaphore()),
-        _logicalDevice.createObjectPointer(_logicalDevice.createSemaphore())};
+    std::vector<avocado::vulkan::CommandBuffer> cmdBuffers = _logicalDevice.allocateCommandBuffers(_framesInFlight, commandPool.get(), VK_COMMAND_BUFFER_LEVEL_PRIMARY);
     if (_logicalDevice.hasError()) {
-        std::cout << "Can't create semaphore: " << _logicalDevice.getErrorMessage() << std::endl;
+        std::cout << "Can't allocate command buffers (" << _logicalDevice.getErrorMessage() << ")." << std::endl;
         return 1;
     }
 
-    std::array<avocado::vulkan::FencePtr, FRAMES_IN_FLIGHT> fences = {
-        _logicalDevice.createObjectPointer(_logicalDevice.createFence()),
-        _logicalDevice.createObjectPointer(_logicalDevice.createFence())};
-    std::vector<VkFence> fenceHandles {fences[0].get(), fences[1].get()};
+    avocado::vulkan::Queue graphicsQueue(_logicalDevice.getGraphicsQueue(0));
+    debugUtilsPtr->setObjectName(graphicsQueue.getHandle(), "Graphics queue");
+
+    // Uploads run on a transfer-only queue if there is one, overlapping with rendering.
+    avocado::vulkan::Queue transferQueue(_logicalDevice.getTransferQueue(0));
+    avocado::vulkan::CommandPoolPtr transferCommandPool = _logicalDevice.createObjectPointer(_logicalDevice.createCommandPool(VK_COMMAND_POOL_CREATE_TRANSIENT_BIT, transferQueueFamily));
     if (_logicalDevice.hasError()) {
-        std::cout << "Can't create fence: " << _logicalDevice.getErrorMessage() << std::endl;
+        std::cout << "Can't create transfer command pool: " << _logicalDevice.getErrorMessage() << std::endl;
         return 1;
     }
 
-    avocado::vulkan::Queue graphicsQueue(_logicalDevice.getGraphicsQueue(0));
-    debugUtilsPtr->setObjectName(graphicsQueue.getHandle(), "Graphics queue");
-
 
     if (swapChain.hasError()) {
         std::cout << "Can't get img index " << swapChain.getErrorMessage() << std::endl;
@@ -607,7 +583,7 @@ int Application::run() {
     imgSize = imgW * imgH * convertedSurface->format->BytesPerPixel;
 
     avocado::vulkan::Buffer imgTransferBuffer(imgSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_SHARING_MODE_EXCLUSIVE, _logicalDevice);
-    imgTransferBuffer.allocateMemory(_physicalDevice, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    imgTransferBuffer.allocateMemory(_physicalDevice, avocado::vulkan::MemoryUsage::Upload);
     imgTransferBuffer.fill(convertedSurface->pixels);
     imgTransferBuffer.bindMemory();
 
@@ -629,82 +605,283 @@ int Application::run() {
         return 1;
     }
 
-    textureImage.allocateMemory(_physicalDevice, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    textureImage.allocateMemory(_physicalDevice, avocado::vulkan::MemoryUsage::GpuOnly);
     textureImage.bindMemory();
 
     avocado::vulkan::ImageViewPtr textureImageView = _logicalDevice.createObjectPointer(swapChain.createImageView(textureImage.getHandle(), VK_FORMAT_R8G8B8A8_SRGB));
     swapChain.createFramebuffers(renderPassPtr.get(), extent);
 
-    transitionImageLayout(_logicalDevice, commandPool.get(), graphicsQueue, textureImage.getHandle(), VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
-    copyBufferToImage(_logicalDevice, commandPool.get(), graphicsQueue, imgTransferBuffer, textureImage, static_cast<uint32_t>(imgW), static_cast<uint32_t>(imgH));
-    transitionImageLayout(_logicalDevice, commandPool.get(), graphicsQueue, textureImage.getHandle(), VK_FORMAT_R8G8B8A8_SRGB, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    // All texture uploads go into one command buffer and one submission.
+    // The first frame waits for the upload semaphore and acquires the texture on the graphics queue.
+    VkSemaphore uploadSemaphore = _logicalDevice.getSemaphorePool().acquire();
+    if (_logicalDevice.getSemaphorePool().hasError()) {
+        std::cout << "Can't acquire upload semaphore: " << _logicalDevice.getSemaphorePool().getErrorMessage() << std::endl;
+        return 1;
+    }
 
-    avocado::vulkan::SamplerPtr textureSamplerPtr = _logicalDevice.createSampler(_physicalDevice);
-    if (_logicalDevice.hasError()) {
-        std::cout << "Error while creating sampler (" << _logicalDevice.getErrorMessage() << ")" << std::endl;
+    avocado::vulkan::UploadBatch uploadBatch(_logicalDevice, transferCommandPool.get());
+    uploadBatch.copyBufferToImage(imgTransferBuffer, textureImage, static_cast<uint32_t>(imgW), static_cast<uint32_t>(imgH));
+    uploadBatch.releaseImage(textureImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+        transferQueueFamily, graphicsQueueFamily);
+    uploadBatch.addStagingBuffer(std::move(imgTransferBuffer));
+    uploadBatch.submit(transferQueue, uploadSemaphore);
+    if (uploadBatch.hasError()) {
+        std::cout << "Upload batch error: " << uploadBatch.getErrorMessage() << std::endl;
+        return 1;
+    }
+
+    avocado::vulkan::SamplerDescription textureSamplerDescription;
+    textureSamplerDescription.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER;
+    textureSamplerDescription.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER;
+    textureSamplerDescription.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_BORDER;
+    textureSamplerDescription.maxLod = 0.f;
+    avocado::vulkan::SamplerCache &samplerCache = _logicalDevice.getSamplerCache();
+    VkSampler textureSampler = samplerCache.getSampler(textureSamplerDescription);
+    if (samplerCache.hasError()) {
+        std::cout << "Error while creating sampler (" << samplerCache.getErrorMessage() << ")" << std::endl;
+        return 1;
+    }
+
+    // Matches the bindings of the layout, the descriptors of a frame slot are pushed with one call.
+    struct SceneDescriptors {
+        VkDescriptorBufferInfo uniformBuffer;
+        VkDescriptorImageInfo texture;
+    };
+
+    avocado::vulkan::DescriptorUpdateTemplate pushTemplate(_logicalDevice.getHandle());
+    std::vector<SceneDescriptors> sceneDescriptors;
+    std::vector<VkDescriptorSet> descriptorSets;
+    if (isPushDescriptorEnabled) {
+        pushTemplate.addEntry(0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, offsetof(SceneDescriptors, uniformBuffer));
+        pushTemplate.addEntry(1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, offsetof(SceneDescriptors, texture));
+        pushTemplate.createForPushDescriptors(VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0);
+        if (pushTemplate.hasError()) {
+            std::cout << "Can't create push descriptor template: " << pushTemplate.getErrorMessage() << std::endl;
+            return 1;
+        }
+
+        for (avocado::vulkan::Buffer *uniformBuffer : uniformBuffers) {
+            SceneDescriptors &descriptors = sceneDescriptors.emplace_back();
+            descriptors.uniformBuffer = {uniformBuffer->getHandle(), 0, sizeof(UniformBufferObject)};
+            descriptors.texture = {textureSampler, textureImageView.get(), VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
+        }
+    } else if (!getDescriptorSets(descriptorSetLayoutPtr.get(), uniformBuffers, sizeof(UniformBufferObject), descriptorSets, textureImageView, textureSampler)) {
         return 1;
     }
 
-    updateDescriptorSets(uniformBuffers, sizeof(UniformBufferObject), descriptorSets, textureImageView, textureSamplerPtr);
-    VkBuffer vertexBufferHandle = vertexBuffer.getHandle();
+    // Loading ends here, the scene isn't drawn without its pipeline. Optimized relinks of fast-linked
+    // pipelines go on in the background.
+    VkPipeline graphicsPipeline = pipelineFutures.front().get();
+    if (graphicsPipeline == VK_NULL_HANDLE) {
+        std::cout << "Error: invalid pipeline (" << pipelineCompiler.getLastFailureMessage() << ")" << std::endl;
+        return 1;
+    }
     VkDeviceSize offset = 0;
-    auto startTime = std::chrono::high_resolution_clock::now();
 
-    std::vector<VkPipelineStageFlags> flags = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
-    std::vector<VkSemaphore> waitSemaphores {imageAvailableSemaphores[0].get(), imageAvailableSemaphores[1].get()};
-    std::vector<VkSemaphore> signalSemaphores {renderFinishedSemaphores[0].get(), renderFinishedSemaphores[1].get()};
     std::vector cmdBufferHandles = avocado::vulkan::getCommandBufferHandles(cmdBuffers);
 
-    SDL_Event event;
-    uint32_t imageIndex = 0;//swapChain.acquireNextImage(imageAvailableSemaphores[0].get());
-    uint32_t currentFrame = 0;
+    // The scene doesn't change, only the uniform buffer of the frame does. So scene commands are recorded
+    // once per frame slot and replayed; bump sceneVersion whenever draw inputs change. The commands are
+    // recorded again as well when the registry replaces the pipeline, which the render thread tracks.
+    avocado::vulkan::CommandBufferCache sceneCommandCache(_logicalDevice, commandPool.get(), frameScheduler.getFramesInFlight());
+    if (sceneCommandCache.hasError()) {
+        std::cout << "Can't create scene command cache: " << sceneCommandCache.getErrorMessage() << std::endl;
+        return 1;
+    }
 
-    // Main loop.
-    while (true) {
-        if (SDL_PollEvent(&event)) {
-            if ((event.type == SDL_QUIT) || (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_ESCAPE))
+    const uint64_t sceneVersion = 0;
+    const auto recordScene = [&](avocado::vulkan::CommandBuffer &sceneCommands, const uint32_t slot) {
+        sceneCommands.setViewports(viewPorts);
+        sceneCommands.setScissors(scissors);
+        sceneCommands.setCullMode(VK_CULL_MODE_BACK_BIT);
+        sceneCommands.setFrontFace(VK_FRONT_FACE_CLOCKWISE);
+        sceneCommands.setPrimitiveTopology(VK_PRIMITIVE_TOPOLOGY_TRIANGLE_FAN);
+        VkBuffer vertexBufferHandle = animatedVertexBuffers[slot].getHandle();
+        sceneCommands.bindVertexBuffers(0, 1, &vertexBufferHandle, &offset);
+        sceneCommands.bindIndexBuffer(indexBuffer.getHandle(), 0, avocado::vulkan::toIndexType<decltype(indices)::value_type>());
+        sceneCommands.bindPipeline(graphicsPipeline, VK_PIPELINE_BIND_POINT_GRAPHICS);
+        if (isPushDescriptorEnabled) {
+            sceneCommands.pushDescriptorSetWithTemplate(_logicalDevice.getPushDescriptorCommands(), pushTemplate.getHandle(),
+                pipelineLayout, 0, sceneDescriptors[slot]);
+        } else {
+            sceneCommands.bindDescriptorSets(VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1, &descriptorSets[slot], 0, nullptr);
+        }
+        sceneCommands.drawIndexed(static_cast<uint32_t>(indices.size()), 1, 0, 0, 0);
+    };
+
+    // Immutable snapshot of everything the render thread needs for one frame.
+    struct RenderPacket {
+        UniformBufferObject ubo{};
+        float time = 0.f;
+        uint64_t sceneVersion = 0;
+        bool isLast = false;
+    };
+
+    // Simulation runs on this thread and may be ahead of rendering by up to the queue depth,
+    // so simulating frame N + 1 overlaps with recording and submitting frame N.
+    avocado::core::SpscQueue<RenderPacket> renderPackets(_renderPacketQueueDepth);
+    std::atomic<bool> isRenderThreadFailed = false;
+    avocado::vulkan::PipelineRegistry &pipelineRegistry = _logicalDevice.getPipelineRegistry();
+    std::thread renderThread([&]() {
+        uint32_t imageIndex = 0;
+        uint64_t scenePipelineGeneration = 0;
+        bool isUploadAcquired = false;
+        RenderPacket packet;
+        // Sleeps until the simulation produces the next packet.
+        while (renderPackets.pop(packet)) {
+            if (packet.isLast)
+                break;
+
+            frameScheduler.beginFrame();
+            if (frameScheduler.hasError()) {
+                std::cout << "Frame scheduler error: " << frameScheduler.getErrorMessage() << std::endl;
+                break;
+            }
+
+            const uint32_t currentFrame = frameScheduler.getFrameIndex();
+            imageIndex = swapChain.acquireNextImage(frameScheduler.getImageAvailableSemaphore());
+            uniformBuffers[currentFrame]->fill(&packet.ubo);
+
+            frameDescriptorAllocator.beginFrame(currentFrame);
+            VkDescriptorSet computeDescriptorSet = frameDescriptorAllocator.allocate(computeDescriptorSetLayoutPtr.get());
+            if (frameDescriptorAllocator.hasError()) {
+                std::cout << "Can't allocate compute descriptor set: " << frameDescriptorAllocator.getErrorMessage() << std::endl;
+                break;
+            }
+
+            QuadDescriptors quadDescriptors{};
+            quadDescriptors.sourceVertices = {vertexBuffer.getHandle(), 0, VK_WHOLE_SIZE};
+            quadDescriptors.vertices = {animatedVertexBuffers[currentFrame].getHandle(), 0, VK_WHOLE_SIZE};
+            computeUpdateTemplate.update(computeDescriptorSet, quadDescriptors);
+
+            avocado::vulkan::CommandBuffer &computeCommands = asyncCompute.begin(currentFrame);
+            if (asyncCompute.hasError()) {
+                std::cout << "Can't begin compute commands: " << asyncCompute.getErrorMessage() << std::endl;
+                break;
+            }
+
+            computeCommands.bindPipeline(computePipeline.get(), VK_PIPELINE_BIND_POINT_COMPUTE);
+            computeCommands.bindDescriptorSets(VK_PIPELINE_BIND_POINT_COMPUTE, computePipelineLayout, 0, 1, &computeDescriptorSet);
+            computeCommands.pushConstants(computePipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT,
+                QuadConstants{packet.time, static_cast<uint32_t>(quad.size())});
+            computeCommands.dispatch(1);
+            asyncCompute.releaseBuffer(animatedVertexBuffers[currentFrame], VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                VK_ACCESS_2_SHADER_WRITE_BIT, VK_ACCESS_2_VERTEX_ATTRIBUTE_READ_BIT, graphicsQueueFamily);
+            const uint64_t computeValue = asyncCompute.submit(computeQueue);
+            if (asyncCompute.hasError()) {
+                std::cout << "Can't submit compute commands: " << asyncCompute.getErrorMessage() << std::endl;
+                break;
+            }
+
+            avocado::vulkan::CommandBuffer commandBuffer = cmdBuffers[currentFrame];
+            commandBuffer.reset(static_cast<VkCommandPoolResetFlagBits>(0));
+            commandBuffer.begin();
+            if (!isUploadAcquired) {
+                uploadBatch.recordAcquireBarriers(commandBuffer, VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT);
+                frameScheduler.addWaitSemaphore(uploadSemaphore, VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT);
+                frameScheduler.retire([this, uploadSemaphore]() {
+                    _logicalDevice.getSemaphorePool().release(uploadSemaphore);
+                });
+                isUploadAcquired = true;
+            }
+            asyncCompute.recordAcquireBarriers(commandBuffer, VK_PIPELINE_STAGE_2_VERTEX_INPUT_BIT);
+            frameScheduler.addWaitSemaphore(asyncCompute.getTimeline(), VK_PIPELINE_STAGE_2_VERTEX_INPUT_BIT, computeValue);
+            // Replaced pipelines are destroyed when this frame is done, the earlier frames which could use them are done by then.
+            const uint64_t pipelineGeneration = pipelineRegistry.getGeneration();
+            if (pipelineGeneration != scenePipelineGeneration) {
+                frameScheduler.retire([this, replacedPipelines = pipelineRegistry.takeReplacedPipelines()]() {
+                    for (VkPipeline pipeline : replacedPipelines)
+                        vkDestroyPipeline(_logicalDevice.getHandle(), pipeline, nullptr);
+                });
+                graphicsPipeline = pipelineRegistry.findGraphicsPipeline(scenePipelineKey);
+                scenePipelineGeneration = pipelineGeneration;
+            }
+
+            // Both parts only grow, so the sum changes whenever one of them does.
+            const uint64_t sceneCommandsVersion = packet.sceneVersion + scenePipelineGeneration;
+            VkCommandBuffer sceneCommands = sceneCommandCache.get(currentFrame, sceneCommandsVersion, renderPassPtr.get(), 0, recordScene);
+            if (sceneCommandCache.hasError()) {
+                std::cout << "Can't record scene commands: " << sceneCommandCache.getErrorMessage() << std::endl;
                 break;
+            }
+
+            commandBuffer.beginRenderPass(swapChain, renderPassPtr.get(), extent, {0, 0}, imageIndex, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+            commandBuffer.executeCommands({sceneCommands});
+            commandBuffer.endRenderPass();
+            commandBuffer.end();
+
+            frameScheduler.submit(graphicsQueue, cmdBufferHandles[currentFrame], VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT);
+            if (frameScheduler.hasError()) {
+                std::cout << "Can't submit graphics queue: " << frameScheduler.getErrorMessage() << std::endl;
+                break;
+            }
+
+            VkSemaphore renderFinishedSemaphore = frameScheduler.getRenderFinishedSemaphore();
+            presentQueue.present(renderFinishedSemaphore, imageIndex, swapChainHandles[0]);
+        }
+
+        isRenderThreadFailed = !packet.isLast;
+        // Wakes up the simulation if it waits for a free slot.
+        renderPackets.close();
+    });
+
+    // Main loop. SDL events have to be polled on the thread which created the window.
+    // The simulation advances in fixed ticks, so its result doesn't depend on the frame rate. Ticks missed
+    // while the render thread was behind are caught up at once, only the latest state is rendered.
+    SDL_Event event;
+    bool isRunning = true;
+    auto pipelineCacheSaveTime = std::chrono::high_resolution_clock::now();
+    auto previousTime = pipelineCacheSaveTime;
+    std::chrono::nanoseconds unsimulatedTime{0};
+    uint64_t tickCount = 0;
+    while (isRunning && !isRenderThreadFailed) {
+        while (SDL_PollEvent(&event)) {
+            if ((event.type == SDL_QUIT) || (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_ESCAPE))
+                isRunning = false;
         }
 
-        std::vector<VkFence> fenceToWait{fences[currentFrame].get()};
-        _logicalDevice.waitForFences(fenceToWait, true);
-        imageIndex = swapChain.acquireNextImage(imageAvailableSemaphores[currentFrame].get());
-        _logicalDevice.resetFences(fenceToWait);
-
-        // Update uniform buffer.
-        auto currentTime = std::chrono::high_resolution_clock::now();
-        float time = std::chrono::duration<float, std::chrono::seconds::period>(currentTime - startTime).count();
-        ubo.model = avocado::math::Mat4x4::createIdentityMatrix() * avocado::math::createRotationMatrix(time * 90.f, avocado::math::vec3f(0.0f, 0.0f, 1.0f));
-        uniformBuffers[currentFrame]->fill(&ubo);
-
-        avocado::vulkan::CommandBuffer commandBuffer = cmdBuffers[currentFrame];
-        commandBuffer.reset(static_cast<VkCommandPoolResetFlagBits>(0));
-        commandBuffer.begin();
-        commandBuffer.beginRenderPass(swapChain, renderPassPtr.get(), extent, {0, 0}, imageIndex);
-
-        commandBuffer.setViewports(viewPorts);
-        commandBuffer.setScissors(scissors);
-        commandBuffer.bindVertexBuffers(0, 1, &vertexBufferHandle, &offset);
-        commandBuffer.bindIndexBuffer(indexBuffer.getHandle(), 0, avocado::vulkan::toIndexType<decltype(indices)::value_type>());
-        commandBuffer.bindPipeline(graphicsPipeline.get(), VK_PIPELINE_BIND_POINT_GRAPHICS);
-        commandBuffer.bindDescriptorSets(VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineBuilder.getPipelineLayout(), 0, 1, &descriptorSets[currentFrame], 0, nullptr);
-        commandBuffer.drawIndexed(static_cast<uint32_t>(indices.size()), 1, 0, 0, 0);
-
-        commandBuffer.endRenderPass();
-        commandBuffer.end();
-
-        auto submitInfo = graphicsQueue.createSubmitInfo(waitSemaphores[currentFrame], signalSemaphores[currentFrame], cmdBufferHandles[currentFrame], flags);
-        graphicsQueue.submit(submitInfo, fenceToWait[0]);
-        if (graphicsQueue.hasError()) {
-            std::cout << "Can't submit graphics queue: " << graphicsQueue.getErrorMessage() << std::endl;
-            break;
+        const auto currentTime = std::chrono::high_resolution_clock::now();
+        unsimulatedTime += currentTime - previousTime;
+        previousTime = currentTime;
+
+        // Pipelines compiled since the last save survive a crash.
+        if (currentTime - pipelineCacheSaveTime > _pipelineCacheSaveInterval) {
+            pipelineCache.saveIfChanged();
+            pipelineCacheSaveTime = currentTime;
         }
 
-        presentQueue.present(signalSemaphores[currentFrame], imageIndex, swapChainHandles[0]);
-        currentFrame = (currentFrame + 1) % FRAMES_IN_FLIGHT;
+        if (unsimulatedTime < _simulationTick) {
+            std::this_thread::sleep_for(_simulationTick - unsimulatedTime);
+            continue;
+        }
+
+        while (unsimulatedTime >= _simulationTick) {
+            ++tickCount;
+            unsimulatedTime -= _simulationTick;
+        }
+        const float time = std::chrono::duration<float>(_simulationTick * tickCount).count();
+
+        RenderPacket packet;
+        packet.ubo = ubo;
+        packet.ubo.model = avocado::math::Mat4x4::createIdentityMatrix() * avocado::math::createRotationMatrix(time * 90.f, avocado::math::vec3f(0.0f, 0.0f, 1.0f));
+        packet.time = time;
+        packet.sceneVersion = sceneVersion;
+        // Blocks while the render thread is the queue depth behind. Fails only if the render thread stopped.
+        renderPackets.push(std::move(packet));
     } // Main loop.
 
+    RenderPacket lastPacket;
+    lastPacket.isLast = true;
+    renderPackets.push(std::move(lastPacket));
+    renderThread.join();
+
+    // Pipelines still being compiled would reach the cache after the last save otherwise.
+    pipelineCompiler.waitIdle();
     _logicalDevice.waitIdle();
+    pipelineCache.saveIfChanged();
+    if (pipelineCache.hasError())
+        std::cerr << "Can't save pipeline cache: " << pipelineCache.getErrorMessage() << std::endl;
+
     return 0;
 }
 
@@ -7,11 +7,16 @@
 
 #include <SDL.h>
 
+#include <chrono>
 #include <memory>
 
 class Application {
 public:
     int run();
+    // Sizes the frame scheduler and the per-frame resources, has to be called before run().
+    void setFramesInFlight(const uint32_t framesInFlight) noexcept;
+    // How many render packets the simulation may produce ahead of the render thread, has to be called before run().
+    void setRenderPacketQueueDepth(const size_t renderPacketQueueDepth) noexcept;
 
 private:
     void createInstance(SDL_Window &window, const std::vector<std::string> &instanceLayers);
@@ -28,13 +33,19 @@ private:
         std::vector<VkDescriptorSetLayout> &layouts, const std::vector<VkViewport> &viewPorts,
         const std::vector<VkRect2D> &scissors);
 
-    void updateDescriptorSets(std::vector<avocado::vulkan::Buffer*> &uniformBuffers, const VkDeviceSize range, std::vector<VkDescriptorSet> &descriptorSets,
-        avocado::vulkan::ImageViewPtr &textureImageView, avocado::vulkan::SamplerPtr &textureSampler);
+    bool getDescriptorSets(VkDescriptorSetLayout layout, std::vector<avocado::vulkan::Buffer*> &uniformBuffers, const VkDeviceSize range,
+        std::vector<VkDescriptorSet> &descriptorSets, avocado::vulkan::ImageViewPtr &textureImageView, VkSampler textureSampler);
 
     avocado::vulkan::Vulkan _vulkan;
     avocado::vulkan::PhysicalDevice _physicalDevice;
     avocado::vulkan::LogicalDevice _logicalDevice;
-    static constexpr size_t FRAMES_IN_FLIGHT = 2;
+    uint32_t _framesInFlight = 2;
+    // How many render packets the simulation may produce ahead of the render thread.
+    size_t _renderPacketQueueDepth = 2;
+    // Fixed step of the simulation, 60 ticks per second.
+    std::chrono::nanoseconds _simulationTick{16'666'667};
+    std::chrono::seconds _pipelineCacheSaveInterval{30};
+    uint32_t _pipelineCompilerThreadCount = 2;
 };
 
 #endif // APPLICATION_HPP
@@ -1,7 +1,16 @@
 #include "application.hpp"
 
+#include <cstdlib>
+
 int main(int argc, char ** argv) {
     Application app;
+    // The optional argument is the number of frames in flight.
+    if (argc > 1) {
+        const unsigned long framesInFlight = std::strtoul(argv[1], nullptr, 10);
+        if (framesInFlight > 0)
+            app.setFramesInFlight(static_cast<uint32_t>(framesInFlight));
+    }
+
     return app.run();
 }
 
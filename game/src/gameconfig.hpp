@@ -7,6 +7,7 @@ struct Config {
     static constexpr uint32_t GAME_MINOR_VERSION = 1;
     static constexpr uint32_t GAME_PATCH_VERSION = 0;
     static inline const std::string SHADERS_PATH = "assets/shaders";
+    static inline const std::string PIPELINE_CACHE_PATH = "pipelinecache.bin";
     static constexpr int RESOLUTION_WIDTH = 800;
     static constexpr int RESOLUTION_HEIGHT = 600;
 };